@@ -0,0 +1,293 @@
+// Micro-benchmarks for the GUI's own per-pixel code. Runs on synthetic maps
+// with a known number of colours and writes the timings as json, so two runs
+// can be compared after a change.
+//
+//   FastWorldGenGUI_bench [--config folder] [--out file] [--sizes 1024,4096]
+//                         [--colours 8,64] [--repeats n]
+#include "FastWorldGenerator.h"
+#include "UI/ClimateUI.h"
+#include "UI/UIContext.h"
+#include "UI/UIUtils.h"
+#include "UI/landUI.h"
+#include "utils/Logging.h"
+#include <algorithm>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace pt = boost::property_tree;
+
+namespace {
+struct Options {
+  std::string configFolder = "configs/default/";
+  std::string outputFile = "benchResults.json";
+  std::vector<int> sizes{1024, 4096, 8192};
+  std::vector<int> colours{8, 64, 1024};
+  int repeats = 5;
+};
+
+std::vector<int> splitInts(const std::string &list) {
+  std::vector<int> values;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    values.push_back(std::stoi(item));
+  }
+  return values;
+}
+
+bool parseArguments(int argc, char *argv[], Options &options) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string flag = argv[i];
+    const std::string value = argv[i + 1];
+    if (flag == "--config") {
+      options.configFolder = value;
+    } else if (flag == "--out") {
+      options.outputFile = value;
+    } else if (flag == "--sizes") {
+      options.sizes = splitInts(value);
+    } else if (flag == "--colours") {
+      options.colours = splitInts(value);
+    } else if (flag == "--repeats") {
+      options.repeats = std::max(1, std::stoi(value));
+    } else {
+      Fwg::Utils::Logging::logLine("Unknown argument ", flag);
+      return false;
+    }
+  }
+  return argc % 2 == 1;
+}
+
+// times run repeats times, prepare is called before every repeat and is not
+// part of the measurement
+class Runner {
+  const Options &options;
+  pt::ptree results;
+
+public:
+  explicit Runner(const Options &options) : options(options) {}
+
+  void measure(const std::string &name, int width, int height, int colours,
+               const std::function<void()> &run,
+               const std::function<void()> &prepare = {}) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<double> seconds;
+    for (int i = 0; i < options.repeats; i++) {
+      if (prepare) {
+        prepare();
+      }
+      const auto start = Clock::now();
+      run();
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+      seconds.push_back(elapsed.count());
+    }
+    std::sort(seconds.begin(), seconds.end());
+    const double best = seconds.front();
+    const double median = seconds[seconds.size() / 2];
+    const double megapixels = static_cast<double>(width) * height / 1e6;
+
+    pt::ptree result;
+    result.put("name", name);
+    result.put("width", width);
+    result.put("height", height);
+    result.put("colours", colours);
+    result.put("repeats", options.repeats);
+    result.put("bestSeconds", best);
+    result.put("medianSeconds", median);
+    result.put("megapixelsPerSecond", best > 0.0 ? megapixels / best : 0.0);
+    results.push_back({"", result});
+    Fwg::Utils::Logging::logLine(name, " ", width, "x", height, " ", colours,
+                                 " colours: best ", best, "s, median ",
+                                 median, "s");
+  }
+
+  bool write() const {
+    pt::ptree root;
+    root.put("repeats", options.repeats);
+    root.add_child("results", results);
+    try {
+      pt::write_json(options.outputFile, root);
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Couldn't write ",
+                                   options.outputFile, ": ", e.what());
+      return false;
+    }
+    Fwg::Utils::Logging::logLine("Wrote results to ", options.outputFile);
+    return true;
+  }
+};
+
+// count distinct colours, at most half of them taken from known so the rest
+// needs classification
+std::vector<Fwg::Gfx::Colour>
+palette(const std::vector<Fwg::Gfx::Colour> &known, int count) {
+  std::vector<Fwg::Gfx::Colour> colours(
+      known.begin(), known.begin() + std::min<std::size_t>(known.size(),
+                                                           count / 2));
+  for (int i = 0; (int)colours.size() < count; i++) {
+    const Fwg::Gfx::Colour colour(static_cast<unsigned char>(i * 37 % 256),
+                                  static_cast<unsigned char>(i / 7 % 256),
+                                  static_cast<unsigned char>(i * 11 % 256));
+    if (std::find(colours.begin(), colours.end(), colour) == colours.end() &&
+        std::find(known.begin(), known.end(), colour) == known.end()) {
+      colours.push_back(colour);
+    }
+  }
+  return colours;
+}
+
+// blocks of 16x16 pixels, so every colour of the palette covers whole regions
+// like on a hand painted input map
+Fwg::Gfx::Image syntheticMap(int width, int height,
+                             const std::vector<Fwg::Gfx::Colour> &colours) {
+  Fwg::Gfx::Image image(width, height, 24);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const unsigned int block = (y / 16) * 73856093u ^ (x / 16) * 19349663u;
+      image.imageData[static_cast<std::size_t>(y) * width + x] =
+          colours[block % colours.size()];
+    }
+  }
+  return image;
+}
+
+// one line in three carries emphasised segments
+std::string syntheticHelpText(int lines) {
+  std::string text;
+  for (int i = 0; i < lines; i++) {
+    text += "The heightmap is generated from **layers** of noise";
+    if (i % 3 == 0) {
+      text += ", each one **scaled** and **weighted** before blending";
+    }
+    text += "\n";
+  }
+  return text;
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  Options options;
+  if (!parseArguments(argc, argv, options)) {
+    return -1;
+  }
+  auto &cfg = Fwg::Cfg::Values();
+  try {
+    cfg.readConfig(options.configFolder);
+  } catch (const std::exception &e) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't read config ",
+                                 options.configFolder, ": ", e.what());
+    return -1;
+  }
+  Fwg::FastWorldGenerator fwg;
+  fwg.configure(cfg);
+
+  // the analysis functions lay out ImGui items, so they need a frame, but no
+  // window or renderer
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+  unsigned char *fontPixels = nullptr;
+  int fontWidth = 0;
+  int fontHeight = 0;
+  io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight);
+  ImGui::NewFrame();
+  ImGui::Begin("Benchmark");
+
+  Fwg::LandUI landUI;
+  std::vector<Fwg::Gfx::Colour> landforms;
+  for (const auto &definition : cfg.terrainConfig.landformDefinitions) {
+    landUI.allowedLandInputs.setValue(definition.colour, definition);
+    landforms.push_back(definition.colour);
+  }
+  Fwg::UI::UIContext uiContext;
+  std::vector<Fwg::Gfx::Colour> climates;
+  for (const auto &definition : fwg.climateData.climateClassDefinitions) {
+    uiContext.climateUI.allowedClimateInputs.setValue(definition.primaryColour,
+                                                      definition);
+    climates.push_back(definition.primaryColour);
+  }
+
+  if (landforms.empty() || climates.empty()) {
+    Fwg::Utils::Logging::logLine("ERROR: The config defines no landforms or "
+                                 "climate classes");
+    return -1;
+  }
+
+  Runner runner(options);
+  for (const int width : options.sizes) {
+    const int height = width / 2;
+    for (const int colourCount : options.colours) {
+      const auto landColours = palette(landforms, colourCount);
+      const auto landInput = syntheticMap(width, height, landColours);
+      int classificationsNeeded = 0;
+      runner.measure("analyseLandMap", width, height, colourCount, [&]() {
+        landUI.analyseLandMap(cfg, fwg, landInput, classificationsNeeded);
+      });
+      // the "Apply all" button of the land input tab, with every colour
+      // classified as the first landform
+      std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> landMapping;
+      for (const auto &colour : landColours) {
+        landMapping.emplace_back(colour, landforms.front());
+      }
+      runner.measure(
+          "applyLandClassification", width, height, colourCount,
+          [&]() { landUI.applyHighlighted(); },
+          [&]() {
+            landUI.restoreInput(cfg, fwg, landInput, landMapping,
+                                classificationsNeeded);
+          });
+
+      const auto climateColours = palette(climates, colourCount);
+      const auto climateInput = syntheticMap(width, height, climateColours);
+      runner.measure("analyzeClimateMap", width, height, colourCount, [&]() {
+        Fwg::UI::Climate::Input::analyzeClimateMap(cfg, fwg, climateInput,
+                                                   uiContext);
+      });
+      std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+          climateMapping;
+      for (const auto &colour : climateColours) {
+        climateMapping.emplace_back(colour, climates.front());
+      }
+      runner.measure(
+          "applyClimateClassification", width, height, colourCount,
+          [&]() { Fwg::UI::Climate::Input::applyHighlighted(uiContext); },
+          [&]() {
+            Fwg::UI::Climate::Input::restoreInput(cfg, fwg, climateInput,
+                                                  climateMapping, uiContext);
+          });
+    }
+
+    // independent of the colour count
+    const auto map = syntheticMap(width, height, palette(landforms, 64));
+    runner.measure("getFlipped32bit", width, height, 64, [&]() {
+      const auto pixels = map.getFlipped32bit();
+      ImGui::TextDisabled("%zu", pixels.size());
+    });
+    std::vector<bool> mask(static_cast<std::size_t>(width) * height);
+    for (std::size_t i = 0; i < mask.size(); i++) {
+      mask[i] = map.imageData[i] == landforms.front();
+    }
+    runner.measure("getLandmaskEvaluationAreas", width, height, 2, [&]() {
+      const auto areas =
+          Fwg::UI::Utils::Masks::getLandmaskEvaluationAreas(mask);
+      ImGui::TextDisabled("%zu", areas[0].size());
+    });
+  }
+
+  // the width of these results is the number of text lines
+  for (const int lines : {10, 100, 1000}) {
+    const auto text = syntheticHelpText(lines);
+    runner.measure("RenderEmphasizedText", lines, 1, 0, [&]() {
+      uiContext.helpContext.RenderEmphasizedText(text, 600.0f);
+    });
+  }
+
+  ImGui::End();
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+  return runner.write() ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <atomic>
+
+namespace Fwg::UI {
+
+// Shared flag between the UI thread and a running job. The job polls it at
+// its checkpoints and stops as soon as it sees a request. Only jobs that took
+// a backup to roll back to accept requests, see setCancellable.
+class CancellationToken {
+  std::atomic<bool> cancelled = false;
+  std::atomic<bool> cancellable = false;
+
+public:
+  void cancel() { cancelled = true; }
+  void reset() {
+    cancelled = false;
+    cancellable = false;
+  }
+  bool isCancelled() const { return cancelled; }
+  void setCancellable(bool value) { cancellable = value; }
+  bool isCancellable() const { return cancellable; }
+};
+
+} // namespace Fwg::UI
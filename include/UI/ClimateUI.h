@@ -17,8 +17,23 @@ bool RenderScrollableClimateInput(std::vector<Fwg::Gfx::Colour> &imageData,
 bool analyzeClimateMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                        const Fwg::Gfx::Image &climateInput,
                        UIContext &uiContext);
+// highlights every colour of mapping that the last analysis found, to be
+// classified as its paired colour by the next apply
+void setClassifications(
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+    UIContext &uiContext);
+// applies the classification of every highlighted colour to the climate
+// input as one undoable edit, returns the applied colours
+std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+applyHighlighted(UIContext &uiContext);
 bool complexTerrainMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                            UIContext &uiContext);
+// sets a climate input from a project together with its pending
+// classifications
+void restoreInput(
+    Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg, const Fwg::Gfx::Image &image,
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+    UIContext &uiContext);
 
 } // namespace Input
 
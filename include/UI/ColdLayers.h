@@ -0,0 +1,84 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/LayerFields.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::Stages {
+
+enum class LeanMode { OFF, COMPRESS, SPILL };
+
+// Holds the noise layers of the terrain data while nothing reads them. After
+// the land stage they are taken out of the generator and either compressed in
+// memory or written to a scratch file, and put back on the next read.
+class ColdLayers {
+public:
+  // never modified once freeze made it, so backups can share it
+  struct Stash {
+    // element counts of the shape, land and sea layers
+    std::vector<std::size_t> lengths[3];
+    // compressed layers in the same order, empty when spilled
+    std::vector<std::vector<std::uint8_t>> packed;
+    // the scratch file of spilled layers, removed with the stash
+    std::string file;
+    std::size_t rawBytes = 0;
+    std::size_t heldBytes = 0;
+    ~Stash();
+  };
+  // what a backup takes to undo freezes, thaws and discards of a run
+  struct State {
+    std::shared_ptr<const Stash> stash;
+    bool layered = false;
+  };
+
+private:
+  mutable std::mutex mutex;
+  // nullptr while nothing is held
+  std::shared_ptr<const Stash> stash;
+  // the current heightmap was generated from noise layers, so they have to
+  // be in the generator or held
+  bool layered = false;
+  std::string scratchFolder;
+  unsigned long long spills = 0;
+
+public:
+  std::atomic<LeanMode> mode = LeanMode::OFF;
+
+  static ColdLayers &shared();
+  void setScratchFolder(const std::string &folder);
+  // takes the layers out of the generator, does nothing with mode OFF
+  void freeze(Fwg::FastWorldGenerator &fwg);
+  // puts held layers back, unless the generator has layers again. Returns
+  // false and leaves the generator without layers if one couldn't be
+  // restored, or if a generated heightmap's layers are neither in the
+  // generator nor held.
+  bool thaw(Fwg::FastWorldGenerator &fwg);
+  // drops held layers, for runs and loads that replace the heightmap.
+  // layered is set if the new heightmap comes with noise layers.
+  void discard(bool layered = false);
+  State state() const;
+  void restore(State state);
+  bool frozen() const;
+  // decodes a single held layer without putting it back, group is 0 for
+  // shape, 1 for land and 2 for sea layers
+  bool peek(int group, std::size_t index, LayerField &field) const;
+  // number of held layers of a group
+  std::size_t heldLayers(int group) const;
+  // bytes the layers take in the generator minus what is held for them
+  std::size_t savedBytes() const;
+  std::size_t heldBytes() const;
+};
+
+// lossless, for fields of neighbouring values: each element is xor-ed with
+// its predecessor, split into byte planes and the planes are run length
+// coded
+std::vector<std::uint8_t> pack(const std::uint8_t *data, std::size_t bytes,
+                               std::size_t elementSize);
+bool unpack(const std::vector<std::uint8_t> &packed, std::uint8_t *data,
+            std::size_t bytes, std::size_t elementSize);
+
+} // namespace Fwg::UI::Stages
@@ -0,0 +1,35 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <boost/property_tree/ptree.hpp>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::ConfigFields {
+
+// path of the seed, which the journal tracks on its own
+inline constexpr const char *seedPath = "module.seed";
+
+// A parameter the pipeline editor exposes for an operation type
+struct OperationParameter {
+  enum class Kind { INT, FLOAT, BOOL };
+  const char *name;
+  Kind kind;
+  // used while the operation doesn't have the parameter yet
+  float fallback;
+};
+const std::vector<OperationParameter> &
+operationParameters(Fwg::Terrain::HeightmapOperationType type);
+
+// Every Cfg field the UI edits by its path, grouped like the config files,
+// e.g. map.width or map.heightmap.landLayers.0.weight, with its value as text
+std::map<std::string, std::string> flatten(const Fwg::Cfg &cfg);
+// sets the field at path, returns false if there is none or value is invalid
+bool set(Fwg::Cfg &cfg, const std::string &path, const std::string &value);
+
+// the fields of flatten as a tree, to be written as json
+boost::property_tree::ptree tree(const Fwg::Cfg &cfg);
+// sets every field of the tree, returns false if one of them couldn't be set
+bool apply(const boost::property_tree::ptree &tree, Fwg::Cfg &cfg);
+
+} // namespace Fwg::UI::ConfigFields
@@ -0,0 +1,43 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <string>
+
+namespace Fwg::UI::Drops {
+
+// What a dropped file is loaded as, depends on the tab it was dropped on
+enum class Target {
+  LAND_INPUT,
+  HEIGHTMAP,
+  CLIMATE_INPUT,
+  TEMPERATURE,
+  HUMIDITY,
+  RIVERS,
+  CLIMATE,
+  FORESTS,
+  HABITABILITY,
+  SUPERSEGMENTS,
+  SEGMENTS,
+  PROVINCES,
+  CONTINENTS
+};
+
+struct Drop {
+  Target target;
+  std::string path;
+  // the altitude effect of temperatures and humidity. Climates load the
+  // classified input instead of the file if set.
+  bool option = false;
+};
+
+// Loads the dropped file into the generator data of its target, the way the
+// tab it was dropped on does. Inputs that are classified before they are
+// used are read into input, and climates loading the classified input use
+// it. Returns false if the file couldn't be used.
+bool load(const Drop &drop, Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+          Fwg::Gfx::Image &input);
+
+// target;option;path, as the journal stores it
+std::string text(const Drop &drop);
+bool parse(const std::string &text, Drop &drop);
+
+} // namespace Fwg::UI::Drops
@@ -0,0 +1,94 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Fwg::UI {
+
+// Undo and redo for the classification applies of an input image. An apply
+// is kept as runs of consecutive pixels with their colours before and after
+// it, or as a plain colour swap when it replaced every pixel of a colour with
+// one the image didn't contain.
+class EditHistory {
+public:
+  // consecutive pixels written with the same pair of palette colours
+  struct Span {
+    std::uint32_t start;
+    std::uint32_t length;
+    std::uint32_t before;
+    std::uint32_t after;
+  };
+
+  // collects the writes of one apply, create it before writing pixels
+  class Edit {
+    friend class EditHistory;
+    std::vector<Fwg::Gfx::Colour> &pixels;
+    std::vector<Fwg::Gfx::Colour> palette;
+    std::map<Fwg::Gfx::Colour, std::uint32_t> paletteIds;
+    std::vector<Span> spans;
+    std::uint32_t paletteId(const Fwg::Gfx::Colour &colour);
+
+  public:
+    explicit Edit(std::vector<Fwg::Gfx::Colour> &pixels) : pixels(pixels) {}
+    // writes the colour and records the one it replaced
+    void set(int index, const Fwg::Gfx::Colour &colour);
+    bool empty() const { return spans.empty(); }
+  };
+
+  // colours of an undone or redone apply, before and after it
+  using Changes = std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>;
+
+private:
+  struct Swap {
+    std::uint32_t before;
+    std::uint32_t after;
+  };
+  struct Delta {
+    std::string name;
+    std::vector<Fwg::Gfx::Colour> palette;
+    std::vector<Span> spans;
+    std::vector<Swap> swaps;
+    std::size_t bytes() const;
+    Changes changes() const;
+  };
+
+  std::deque<Delta> undoStack;
+  std::vector<Delta> redoStack;
+  std::size_t budgetBytes;
+  std::size_t usedBytes = 0;
+  // swaps replace long span lists only, short ones are cheaper to keep
+  static constexpr std::size_t swapThreshold = 4096;
+
+  static void compact(Delta &delta,
+                      const std::vector<Fwg::Gfx::Colour> &pixels);
+  static void patch(const Delta &delta, std::vector<Fwg::Gfx::Colour> &pixels,
+                    bool forward);
+
+public:
+  explicit EditHistory(std::size_t budgetBytes = 64ull << 20)
+      : budgetBytes(budgetBytes) {}
+  // stores an applied edit and drops the redo entries, the oldest entries
+  // are dropped above the budget
+  void push(Edit &&edit, const std::string &name);
+  bool canUndo() const { return !undoStack.empty(); }
+  bool canRedo() const { return !redoStack.empty(); }
+  Changes undo(std::vector<Fwg::Gfx::Colour> &pixels);
+  Changes redo(std::vector<Fwg::Gfx::Colour> &pixels);
+  void clear();
+  std::size_t bytes() const { return usedBytes; }
+  // undo and redo buttons with their shortcuts. Undone classifications of
+  // listed input colours are highlighted again. Returns true if the pixels
+  // changed.
+  bool showControls(
+      std::vector<Fwg::Gfx::Colour> &pixels,
+      std::set<Fwg::Gfx::Colour> &highlighted,
+      const std::function<bool(const Fwg::Gfx::Colour &)> &isInput);
+};
+
+} // namespace Fwg::UI
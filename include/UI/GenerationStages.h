@@ -0,0 +1,154 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/Cancellation.h"
+#include "UI/ColdLayers.h"
+#include "UI/Progress.h"
+#include "UI/TripleBuffer.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::Snapshots {
+class Channel;
+}
+namespace Fwg::UI::Journal {
+class Recorder;
+}
+
+namespace Fwg::UI::Stages {
+class StalenessTracker;
+
+enum class StageId {
+  HEIGHTMAP,
+  LAND,
+  NORMALMAP,
+  TEMPERATURE,
+  HUMIDITY,
+  RIVERS,
+  CLIMATE,
+  FORESTS,
+  WORLDMAP,
+  HABITABILITY,
+  SUPERSEGMENTS,
+  SEGMENTS,
+  PROVINCES,
+  CONTINENTS
+};
+
+// Which parts of the generator a stage writes to, used to decide what has to
+// be backed up before a cancellable run
+enum DataGroup : unsigned int {
+  TERRAIN = 1 << 0,
+  CLIMATE = 1 << 1,
+  AREAS = 1 << 2,
+  IMAGES = 1 << 3
+};
+
+struct Stage {
+  StageId id;
+  std::string name;
+  unsigned int writes;
+  // stages whose output this stage reads, mirrors the PrerequisiteChecker
+  // requirements of the matching tab
+  std::vector<StageId> dependencies;
+  // hash of the Cfg fields the stage reads, changes mark the stage stale
+  std::function<std::size_t(const Fwg::Cfg &)> inputs;
+  std::function<bool(Fwg::Cfg &, Fwg::FastWorldGenerator &)> run;
+  // the map the stage fills, shown as a preview once the stage finished
+  std::function<const Fwg::Gfx::Image &(const Fwg::FastWorldGenerator &)>
+      preview;
+  // The stage reads only data no stage after it writes, writes data no other
+  // stage reads and draws no random numbers, so it may overlap any stage.
+  // All others share the generator's data and random engine and run alone.
+  bool isolated = false;
+};
+
+// Copy of the generator data a stage list may modify. Restoring it after a
+// cancelled or failed run brings the generator back to the state before the
+// run. Area objects are shared between copies of AreaData and modified in
+// place by the area stages, so the copy of the areas only holds until the
+// first area stage of the run started.
+struct DataSnapshot {
+  unsigned int groups = 0;
+  Fwg::Terrain::TerrainData terrainData;
+  Fwg::Climate::ClimateData climateData;
+  Fwg::Areas::AreaData areaData;
+  Fwg::Gfx::Image worldMap;
+  Fwg::Gfx::Image segmentMap;
+  Fwg::Gfx::Image provinceMap;
+  Fwg::Gfx::Image errorMap;
+  // held noise layers, which belong to the terrain data
+  ColdLayers::State coldLayers;
+
+  void capture(const Fwg::FastWorldGenerator &fwg, unsigned int groups);
+  void restore(Fwg::FastWorldGenerator &fwg) const;
+};
+
+const Stage &get(StageId id);
+// the full sequence of FastWorldGenerator::generateWorld
+std::vector<Stage> worldStages();
+std::vector<Stage> climateStages();
+std::vector<Stage> areaStages();
+
+struct RunOptions {
+  // shown in the progress display
+  std::string jobName = "Generation";
+  CancellationToken *cancellation = nullptr;
+  Progress::ProgressTracker *progress = nullptr;
+  // clear all generator data after the backup was taken
+  bool resetData = false;
+  // receives the stages that finished, unless the run was cancelled
+  StalenessTracker *staleness = nullptr;
+  // a new view is published after every finished stage
+  Snapshots::Channel *snapshots = nullptr;
+  // receives the maps of finished stages, see Stage::preview
+  TripleBuffer<std::shared_ptr<const Fwg::Gfx::Image>> *livePreview = nullptr;
+  // journals the job while a session is being recorded
+  Journal::Recorder *journal = nullptr;
+};
+
+// FastWorldGen draws from one process-wide random generator, which
+// Cfg::reRandomize seeds. The heightmap takes its noise from the seeds in the
+// layer configs only, every other stage may draw from the generator. Runs
+// hold this lock while they seed it or run such stages, so draws of
+// different runs never interleave.
+std::mutex &randomMutex();
+// Seeds the shared generator from cfg.mapSeed, so a run draws the same as any
+// other run of that seed. Call with randomMutex held; runStages and runGraph
+// do so before their first stage.
+void reseed(Fwg::Cfg &cfg);
+// a new map seed from an engine of its own, which the UI can draw while a run
+// holds randomMutex
+int newSeed();
+
+// Runs the stages in order, checking for cancellation between them. Runs of
+// more than one stage can be cancelled; they back up the data they write and
+// restore it when cancelled or when a stage fails, and return false. Once an
+// area stage started the backup can't restore the areas, so the run can't be
+// cancelled anymore and a failing stage keeps what finished before it.
+bool runStages(const std::vector<Stage> &stages, Fwg::Cfg &cfg,
+               Fwg::FastWorldGenerator &fwg, const RunOptions &options);
+bool runStage(StageId id, Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+              const RunOptions &options);
+
+struct GraphReport {
+  bool finished = false;
+  // longest chain of dependent stages, measured in this run
+  std::vector<StageId> criticalPath;
+  double criticalSeconds = 0.0;
+  double wallSeconds = 0.0;
+  std::string toString() const;
+};
+
+// Runs the stages as a dependency graph. Stages whose dependencies are done
+// are started in list order. If concurrent is set, isolated stages overlap
+// the others, which still run one at a time so a seed always gives the same
+// world. Dependencies on stages outside the given list count as satisfied.
+GraphReport runGraph(const std::vector<Stage> &stages, Fwg::Cfg &cfg,
+                     Fwg::FastWorldGenerator &fwg, const RunOptions &options,
+                     bool concurrent);
+
+} // namespace Fwg::UI::Stages
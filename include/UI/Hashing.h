@@ -0,0 +1,35 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace Fwg::UI::Hashing {
+
+inline void combine(std::size_t &seed, std::size_t value) {
+  seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+template <typename T> inline void add(std::size_t &seed, const T &value) {
+  if constexpr (std::is_enum_v<T>) {
+    combine(seed, std::hash<std::underlying_type_t<T>>{}(
+                      static_cast<std::underlying_type_t<T>>(value)));
+  } else {
+    combine(seed, std::hash<T>{}(value));
+  }
+}
+
+// hash of any number of hashable values, e.g. the Cfg fields a stage reads
+template <typename... Ts> inline std::size_t values(const Ts &...fields) {
+  std::size_t seed = 0;
+  (add(seed, fields), ...);
+  return seed;
+}
+
+std::size_t layer(const LayerConfig &layer);
+std::size_t layers(const std::vector<LayerConfig> &layers);
+// covers the parameters the pipeline editor exposes for each operation type
+std::size_t operation(const Fwg::Terrain::HeightmapOperation &operation);
+std::size_t landforms(const Fwg::Cfg &cfg);
+
+} // namespace Fwg::UI::Hashing
@@ -0,0 +1,41 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::Headless {
+
+struct Options {
+  bool enabled = false;
+  std::vector<int> seeds;
+  // config folders read on top of the loaded config, one batch per folder
+  std::vector<std::string> configs;
+  // Worlds generated at the same time. FastWorldGen shares one random
+  // generator per process, so with more than one every world runs in a
+  // process of its own.
+  int threads = 1;
+  std::string outputFolder;
+  // 0 keeps the configured size
+  int width = 0;
+  int height = 0;
+  // a recorded session journal to replay instead of the batch
+  std::string replayFile;
+  // this program, started once per world when threads is above one
+  std::string executable;
+};
+
+// Reads --headless, --seeds 1,2,3, --seed-range first,count,
+// --configs a,b, --threads n, --out folder, --size width,height and
+// --replay journal. Unknown flags are logged and make the result invalid.
+bool parseArguments(int argc, char *argv[], Options &options);
+
+// Runs the stages of "Generate all fwg data" for every config and seed, without
+// a window. Each world gets its own generator and writes its maps and a
+// timings.json to its own folder. Returns the process exit code.
+int run(const Options &options, const Fwg::Cfg &cfg);
+
+// Replays a session journal and writes the latency of every action to
+// replayLatencies.json in the output folder
+int replay(const Options &options, const Fwg::Cfg &cfg);
+
+} // namespace Fwg::UI::Headless
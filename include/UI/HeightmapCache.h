@@ -0,0 +1,50 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <list>
+#include <mutex>
+#include <vector>
+
+namespace Fwg::UI::Stages {
+
+// Hash of the heightmap inputs after each pipeline operation. [0] covers
+// everything the heightmap reads apart from the pipeline, [k + 1] includes
+// operations 0..k, so the last entry identifies the whole heightmap run.
+std::vector<std::size_t> heightmapChain(const Fwg::Cfg &cfg);
+
+// Keeps the terrain data of recent heightmap runs, keyed by the last chain
+// hash, so switching back to an earlier pipeline state restores its result
+// instead of running the generator again. Bounded by an estimate of the
+// memory the cached terrain data takes.
+class HeightmapCache {
+  struct Entry {
+    std::size_t key;
+    Fwg::Terrain::TerrainData terrainData;
+    std::size_t bytes;
+  };
+
+  mutable std::mutex mutex;
+  // most recently used first
+  std::list<Entry> entries;
+  std::size_t budgetBytes;
+  std::size_t usedBytes = 0;
+  // chain of the run that produced the current heightmap
+  std::vector<std::size_t> currentChain;
+
+public:
+  explicit HeightmapCache(std::size_t budgetBytes = 512ull << 20)
+      : budgetBytes(budgetBytes) {}
+  static HeightmapCache &shared();
+
+  bool restore(std::size_t key, Fwg::FastWorldGenerator &fwg);
+  void store(std::size_t key, const Fwg::FastWorldGenerator &fwg);
+  void setCurrent(const std::vector<std::size_t> &chain);
+  // amount of leading operations that are unchanged since the current
+  // heightmap was made, -1 if no heightmap was made by the pipeline
+  int unchangedOperations(const Fwg::Cfg &cfg) const;
+  bool contains(std::size_t key) const;
+  std::size_t bytes() const;
+  // drops all entries, the current chain stays
+  void clear();
+};
+
+} // namespace Fwg::UI::Stages
@@ -0,0 +1,44 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <boost/property_tree/ptree.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Fwg::UI {
+
+// Reads all heightmap presets of a folder on a worker thread and keeps them
+// parsed in memory. The worker watches the folder and publishes a new catalog
+// when a file changes. A preset holds only the config fields its file
+// defines, so applying it on top of the live config keeps the others.
+class HeightmapPresets {
+public:
+  // never modified after it was published
+  struct Catalog {
+    // the fields each preset sets, by path, see ConfigFields::apply
+    std::map<std::string, boost::property_tree::ptree> presets;
+    unsigned long long version = 0;
+    std::vector<std::string> paths() const;
+    // nullptr if there is no preset at path
+    const boost::property_tree::ptree *find(const std::string &path) const;
+  };
+
+private:
+  std::atomic<std::shared_ptr<const Catalog>> current;
+  std::string folder;
+  // declared last, so it stops before the members it uses go away
+  std::jthread worker;
+
+  void readAll();
+  void watch(std::stop_token stop);
+
+public:
+  void start(const std::string &folder);
+  // nullptr until the folder was read once
+  std::shared_ptr<const Catalog> catalog() const { return current.load(); }
+};
+
+} // namespace Fwg::UI
@@ -1,5 +1,12 @@
 #pragma once
 #include "FastWorldGenerator.h"
+#include "UI/HeightmapCache.h"
+#include "UI/HeightmapPresets.h"
+#include "UI/LayerFields.h"
+#include "UI/LayerThumbnails.h"
+#include "UI/PipelineProfiler.h"
+#include "UI/PipelinePreview.h"
+#include "UI/PresetGallery.h"
 #include "UI/Prerequisites.h"
 #include "UI/UIContext.h"
 #include "UI/UiElements.h"
@@ -9,13 +16,26 @@ class HeightmapUI {
 private:
   int selectedOperationIndex;
   std::vector<std::string> heightmapConfigFiles;
+  HeightmapPresets presets;
+  PresetGallery presetGallery;
+  unsigned long long presetsVersion = 0;
+  PipelinePreview pipelinePreview;
+  PipelineProfiler pipelineProfiler;
+  LayerThumbnails layerThumbnails;
+  bool livePreview = true;
+  // set when a parameter slider was released, runs once the preview is idle
+  bool pendingFullRun = false;
   void renderOperationParameters(Fwg::Terrain::HeightmapOperation &operation);
   void configureLandElevationFactors(Fwg::Cfg &cfg,
                                      Fwg::FastWorldGenerator &fwg);
-  void configurePipelineEditor(Fwg::Cfg &cfg);
+  void showPipelineProfile(const Fwg::Cfg &cfg);
+  void configurePipelineEditor(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                               UIContext &uiContext);
 
 public:
   void loadHeightmapConfigs();
+  // sets the fields the preset defines, from the parsed catalog
+  void applyPreset(Fwg::Cfg &cfg, const std::string &path);
   int showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                        UIContext &uiContext);
 };
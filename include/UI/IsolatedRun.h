@@ -0,0 +1,35 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/GenerationStages.h"
+#include "UI/Snapshots.h"
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Fwg::UI::Stages {
+
+struct IsolatedResult {
+  bool finished = false;
+  // the heightmap, shrunk to the requested width, empty for a width of 0
+  Fwg::Gfx::Image thumbnail;
+  Snapshots::Summary summary;
+  // share of land pixels in the land mask
+  double landShare = 0.0;
+  // landmasses covering at least half a percent of the map
+  int continents = 0;
+  std::vector<std::pair<std::string, double>> stageSeconds;
+  double seconds = 0.0;
+};
+
+// Runs the stages on a generator of its own, configured with its own copy of
+// the config, so nothing is shared with the generator the UI shows. Seeds the
+// shared random generator from settings.mapSeed. Several of these can run at
+// once, though only their heightmaps overlap, see randomMutex. inspect sees
+// the generator after a finished run.
+IsolatedResult runIsolated(
+    Fwg::Cfg settings, const std::vector<Stage> &stages, int thumbnailWidth,
+    const std::function<void(const Fwg::Cfg &,
+                             const Fwg::FastWorldGenerator &)> &inspect = {});
+
+} // namespace Fwg::UI::Stages
@@ -0,0 +1,115 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/IsolatedRun.h"
+#include "UI/UIUtils.h"
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Fwg::UI {
+
+// One of the slots all background jobs of the grids and galleries share, so
+// together they take at most half the hardware threads. Freed when its
+// holder goes away.
+class JobSlot {
+  bool held = false;
+
+public:
+  // an empty slot if all of them are taken
+  static JobSlot take();
+  JobSlot() = default;
+  JobSlot(JobSlot &&other) noexcept : held(std::exchange(other.held, false)) {}
+  JobSlot &operator=(JobSlot &&other) noexcept;
+  ~JobSlot();
+  explicit operator bool() const { return held; }
+};
+
+// Runs work on a thread of its own, which holds the slot until work returns
+template <typename Work>
+std::future<std::invoke_result_t<Work &>> runInSlot(JobSlot slot, Work work) {
+  return std::async(std::launch::async, [slot = std::move(slot),
+                                         work = std::move(work)]() mutable {
+    const auto held = std::move(slot);
+    return work();
+  });
+}
+
+// a world of a grid, generated in the background
+struct GridCell {
+  // generates the world, set until its job started
+  std::function<Stages::IsolatedResult()> work;
+  std::future<Stages::IsolatedResult> job;
+  bool done = false;
+  Stages::IsolatedResult result;
+  GLuint texture = 0;
+};
+
+// Generates the worlds of a grid in job slots and uploads their thumbnails.
+// Jobs of a replaced grid are kept until they finish, so clearing never
+// blocks.
+template <typename Cell> class JobGrid {
+  std::vector<Cell> cells;
+  std::vector<std::future<Stages::IsolatedResult>> retired;
+
+  static bool ready(const std::future<Stages::IsolatedResult> &job) {
+    return job.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+
+public:
+  ~JobGrid() { clear(); }
+  void clear() {
+    for (auto &cell : cells) {
+      Fwg::UI::Utils::freeTexture(&cell.texture);
+      if (cell.job.valid()) {
+        retired.push_back(std::move(cell.job));
+      }
+    }
+    cells.clear();
+  }
+  void add(Cell cell) { cells.push_back(std::move(cell)); }
+  // uploads finished worlds and starts waiting ones, call once per frame.
+  // name describes a cell whose job failed in the log.
+  void update(const std::function<std::string(const Cell &)> &name) {
+    std::erase_if(retired, ready);
+    bool slotsLeft = true;
+    for (auto &cell : cells) {
+      if (cell.job.valid() && ready(cell.job)) {
+        try {
+          cell.result = cell.job.get();
+          int width = 0;
+          int height = 0;
+          if (cell.result.thumbnail.initialised()) {
+            Fwg::UI::Utils::getResourceView(cell.result.thumbnail,
+                                            &cell.texture, &width, &height);
+          }
+        } catch (const std::exception &e) {
+          Fwg::Utils::Logging::logLine("ERROR: ", name(cell),
+                                       " failed: ", e.what());
+        }
+        cell.done = true;
+      }
+      if (!cell.work || !slotsLeft) {
+        continue;
+      }
+      auto slot = JobSlot::take();
+      if (!slot) {
+        slotsLeft = false;
+        continue;
+      }
+      cell.job = runInSlot(std::move(slot), std::move(cell.work));
+      cell.work = nullptr;
+    }
+  }
+  bool running() const {
+    return std::any_of(cells.begin(), cells.end(),
+                       [](const Cell &cell) { return !cell.done; });
+  }
+  bool empty() const { return cells.empty(); }
+  const std::vector<Cell> &all() const { return cells; }
+};
+
+} // namespace Fwg::UI
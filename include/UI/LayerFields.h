@@ -0,0 +1,39 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace Fwg::UI::Stages {
+
+// one evaluated noise layer, as the generator stores it in its terrain data
+using LayerField = std::remove_cvref_t<
+    decltype(std::declval<Fwg::Terrain::TerrainData &>().shapeLayers.front())>;
+
+// Averages blocks of factor x factor pixels of a width x height field. The
+// result is max(1, width / factor) x max(1, height / factor) pixels.
+template <typename Field>
+Field downsample(const Field &in, int width, int height, int factor) {
+  const int outWidth = std::max(1, width / factor);
+  const int outHeight = std::max(1, height / factor);
+  Field out(static_cast<std::size_t>(outWidth) * outHeight);
+  for (int y = 0; y < outHeight; y++) {
+    for (int x = 0; x < outWidth; x++) {
+      double sum = 0.0;
+      int count = 0;
+      for (int sy = y * factor; sy < std::min(height, (y + 1) * factor);
+           sy++) {
+        for (int sx = x * factor; sx < std::min(width, (x + 1) * factor);
+             sx++) {
+          sum += in[static_cast<std::size_t>(sy) * width + sx];
+          count++;
+        }
+      }
+      out[static_cast<std::size_t>(y) * outWidth + x] =
+          static_cast<typename Field::value_type>(count ? sum / count : 0.0);
+    }
+  }
+  return out;
+}
+
+} // namespace Fwg::UI::Stages
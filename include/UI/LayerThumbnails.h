@@ -0,0 +1,53 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/UIUtils.h"
+#include <chrono>
+#include <future>
+#include <map>
+#include <vector>
+
+namespace Fwg::UI {
+
+// Textures of single noise layers for the layer editor. Each layer is
+// rendered alone on a generator of its own at thumbnail size, in a job slot,
+// and cached by its config. Edits are debounced: a layer is only rendered
+// once its config stayed the same for the debounce interval, so dragging a
+// slider doesn't start a job per frame.
+class LayerThumbnails {
+  using Clock = std::chrono::steady_clock;
+  struct Thumbnail {
+    GLuint texture = 0;
+    unsigned long long lastUse = 0;
+  };
+  struct Request {
+    LayerConfig layer;
+    // 0 for shape, 1 for land and 2 for sea layers
+    int group;
+    Clock::time_point firstSeen;
+    unsigned long long lastSeen;
+  };
+
+  std::map<std::size_t, Thumbnail> cache;
+  std::map<std::size_t, Request> requests;
+  std::map<std::size_t, std::future<Fwg::Gfx::Image>> jobs;
+  unsigned long long frame = 0;
+
+  void evict();
+
+public:
+  static constexpr std::size_t capacity = 96;
+  // longer side of a rendered thumbnail
+  static constexpr int resolution = 64;
+  std::chrono::milliseconds debounce{150};
+
+  ~LayerThumbnails();
+  static std::size_t key(const Fwg::Cfg &cfg, const LayerConfig &layer);
+  // Uploads finished renders, starts the ones whose layer stayed unchanged
+  // for the debounce interval and drops the least recently used textures.
+  // Call once per frame before get.
+  void collect(const Fwg::Cfg &cfg);
+  // texture of the layer, 0 until its render finished
+  GLuint get(const Fwg::Cfg &cfg, const LayerConfig &layer, int group);
+};
+
+} // namespace Fwg::UI
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace Fwg::UI {
+
+// Read only view of a whole file. It is mapped rather than read, so only the
+// pages that are touched get loaded.
+class MappedFile {
+  const char *view = nullptr;
+  std::size_t length = 0;
+#if defined(_WIN32)
+  void *file = nullptr;
+  void *mapping = nullptr;
+#endif
+
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  ~MappedFile() { close(); }
+
+  // false for missing and empty files
+  bool open(const std::string &path);
+  void close();
+  const char *data() const { return view; }
+  std::size_t size() const { return length; }
+};
+
+} // namespace Fwg::UI
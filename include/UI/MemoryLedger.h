@@ -0,0 +1,116 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <functional>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace Fwg::UI::Memory {
+
+// pointees of shared pointers already counted, so shared data counts once
+using Seen = std::unordered_set<const void *>;
+
+template <typename T> struct IsVector : std::false_type {};
+template <typename T, typename A>
+struct IsVector<std::vector<T, A>> : std::true_type {};
+template <typename T> struct IsSharedPtr : std::false_type {};
+template <typename T>
+struct IsSharedPtr<std::shared_ptr<T>> : std::true_type {};
+template <typename T> struct IsPair : std::false_type {};
+template <typename A, typename B>
+struct IsPair<std::pair<A, B>> : std::true_type {};
+
+// Bytes a value owns on the heap, following standard containers, shared
+// pointers and images. Members of other classes are not followed, so their
+// own allocations are missing from the estimate.
+template <typename T> std::size_t heapBytes(const T &value, Seen &seen) {
+  if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    return value.capacity() / 8;
+  } else if constexpr (IsVector<T>::value) {
+    std::size_t bytes = value.capacity() * sizeof(typename T::value_type);
+    if constexpr (!std::is_trivially_copyable_v<typename T::value_type>) {
+      for (const auto &element : value) {
+        bytes += heapBytes(element, seen);
+      }
+    }
+    return bytes;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return value.capacity() > 15 ? value.capacity() + 1 : 0;
+  } else if constexpr (IsSharedPtr<T>::value) {
+    if (!value || !seen.insert(value.get()).second) {
+      return 0;
+    }
+    return sizeof(typename T::element_type) + heapBytes(*value, seen);
+  } else if constexpr (IsPair<T>::value) {
+    return heapBytes(value.first, seen) + heapBytes(value.second, seen);
+  } else if constexpr (std::is_same_v<T, Fwg::Gfx::Image>) {
+    return heapBytes(value.imageData, seen);
+  } else if constexpr (std::ranges::range<T>) {
+    // node based containers, with a guess of the per node overhead
+    std::size_t bytes = 0;
+    for (const auto &element : value) {
+      bytes += sizeof(element) + 2 * sizeof(void *) +
+               heapBytes(element, seen);
+    }
+    return bytes;
+  } else {
+    return 0;
+  }
+}
+
+template <typename T> std::size_t heapBytes(const T &value) {
+  Seen seen;
+  return heapBytes(value, seen);
+}
+
+// Bytes of shared areas, including the pixel lists heapBytes can't follow
+// into the area classes
+template <typename T>
+std::size_t areaBytes(const std::vector<std::shared_ptr<T>> &areas,
+                      Seen &seen) {
+  std::size_t bytes = areas.capacity() * sizeof(std::shared_ptr<T>);
+  for (const auto &area : areas) {
+    if (area && seen.insert(area.get()).second) {
+      bytes += sizeof(T) + heapBytes(area->pixels, seen);
+    }
+  }
+  return bytes;
+}
+
+struct Item {
+  std::string name;
+  std::size_t bytes = 0;
+};
+
+struct Group {
+  std::string name;
+  // reads generator data, which is skipped while a job writes it
+  bool readsGenerator = false;
+  std::function<std::vector<Item>()> measure;
+  std::vector<Item> items;
+  std::size_t bytes = 0;
+  bool measured = false;
+};
+
+// Byte counts of all large data, grouped by owner. Measuring everything at
+// once stalls a frame on large maps, so update measures one group per call.
+class Ledger {
+  std::vector<Group> groups;
+  std::size_t next = 0;
+
+public:
+  void add(Group group) { groups.push_back(std::move(group)); }
+  bool empty() const { return groups.empty(); }
+  // generatorBusy skips the groups reading generator data
+  void update(bool generatorBusy);
+  const std::vector<Group> &entries() const { return groups; }
+  std::size_t total() const;
+  // bytes of the groups reading generator data
+  std::size_t generatorTotal() const;
+};
+
+} // namespace Fwg::UI::Memory
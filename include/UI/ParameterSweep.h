@@ -0,0 +1,68 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/JobGrid.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI {
+
+// Generates one world per combination of values of one or two Cfg fields,
+// each on a generator of its own, a few at a time
+class ParameterSweep {
+public:
+  struct Parameter {
+    const char *name;
+    double minimum;
+    double maximum;
+    // last stage reading the field, the sweep runs every stage up to it
+    Stages::StageId lastStage;
+    std::function<double(const Fwg::Cfg &)> get;
+    std::function<void(Fwg::Cfg &, double)> set;
+  };
+  struct Axis {
+    int parameter = 0;
+    double from = 0.0;
+    double to = 1.0;
+    int steps = 4;
+    double value(int step) const;
+  };
+  struct Cell : GridCell {
+    double x = 0.0;
+    double y = 0.0;
+  };
+
+  static const std::vector<Parameter> &parameters();
+
+private:
+  JobGrid<Cell> cells;
+  // axes of the running sweep, the editable ones may have changed since
+  Axis sweptX;
+  Axis sweptY;
+  bool sweptTwo = false;
+  std::vector<Stages::Stage> stages;
+
+public:
+  Axis x{0, 0.2, 0.6, 4};
+  Axis y{1, 0.5, 2.0, 4};
+  bool twoParameters = false;
+  // divisor of the map size for the swept worlds
+  int scale = 4;
+
+  // replaces the matrix with one cell per combination of the axes
+  void start(const Fwg::Cfg &cfg);
+  // uploads finished worlds and starts waiting ones, call once per frame
+  void update();
+  // row major, x varies fastest
+  const std::vector<Cell> &matrix() const { return cells.all(); }
+  int columns() const { return sweptX.steps; }
+  bool sweepsTwo() const { return sweptTwo; }
+  // writes the swept values of the cell into cfg
+  void apply(const Cell &cell, Fwg::Cfg &cfg) const;
+  bool running() const { return cells.running(); }
+  bool empty() const { return cells.empty(); }
+  // one row per cell with the values, metrics and stage timings
+  bool writeCsv(const std::string &path) const;
+};
+
+} // namespace Fwg::UI
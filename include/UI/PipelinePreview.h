@@ -0,0 +1,50 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace Fwg::UI {
+
+// shrinks the pixel radii of the operations for a map reduced by scale
+void scaleOperations(std::vector<Fwg::Terrain::HeightmapOperation> &operations,
+                     int scale);
+
+// Runs the heightmap pipeline at a fraction of the map resolution on its own
+// generator while pipeline parameters are edited. Runs start once edits pause
+// for the debounce interval. The library can't interrupt a running pipeline,
+// so a run that was overtaken by a newer edit is dropped when it finishes and
+// the newest state is run next.
+class PipelinePreview {
+  using Clock = std::chrono::steady_clock;
+
+  Fwg::FastWorldGenerator generator;
+  // the reduced config the running job reads, replaced only between jobs
+  std::unique_ptr<Fwg::Cfg> settings;
+  std::future<Fwg::Gfx::Image> job;
+  // edits are counted, a result is only shown if no edit followed its start
+  unsigned long long latestRequest = 0;
+  unsigned long long jobRequest = 0;
+  unsigned long long shownRequest = 0;
+  std::size_t lastInputs = 0;
+  bool primed = false;
+  Clock::time_point lastEdit;
+
+  void start(const Fwg::Cfg &cfg);
+
+public:
+  // divisor of width and height, 4 or 8
+  int scale = 4;
+  std::chrono::milliseconds debounce{150};
+
+  // Call once per frame. Notices edits of the heightmap inputs and, if
+  // allowStart is set, starts a run once the debounce interval passed.
+  // Returns true and fills frame when a current result arrived.
+  bool update(const Fwg::Cfg &cfg, Fwg::Gfx::Image &frame, bool allowStart);
+  // drops the result of the running job and anything not yet run
+  void discard() { shownRequest = ++latestRequest; }
+  bool idle() const { return !job.valid(); }
+};
+
+} // namespace Fwg::UI
@@ -0,0 +1,72 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI {
+
+struct OperationProfile {
+  // position in the editor's operation list
+  int index;
+  std::string name;
+  Fwg::Terrain::HeightmapOperationType type;
+  double seconds;
+  // Process wide, so other jobs running at the time are included: threads
+  // the process ran with while the operation was running and resident memory
+  // above the level at the start of the run
+  int processThreads;
+  std::size_t processPeakBytes;
+};
+
+struct PipelineProfile {
+  // the reduced size the profile was taken at
+  int width = 0;
+  int height = 0;
+  // heightmap generation without any pipeline operation
+  double baseSeconds = 0.0;
+  double totalSeconds = 0.0;
+  // heightmap inputs when the profile was taken, see heightmapChain
+  std::size_t inputs = 0;
+  std::vector<OperationProfile> operations;
+
+  const OperationProfile *find(int index) const;
+  bool writeJson(const std::string &path) const;
+};
+
+// Measures the enabled pipeline operations one by one on a separate
+// generator. The library runs the whole pipeline in one call, so the profiler
+// runs every prefix of the pipeline and attributes the difference between
+// consecutive prefixes to the added operation. That is quadratic in the
+// operation count, so the runs use a map reduced like the pipeline preview,
+// and each prefix keeps the fastest of a few runs to damp noise. Memory and
+// thread counts are sampled while the runs are going.
+class PipelineProfiler {
+  Fwg::FastWorldGenerator generator;
+  std::unique_ptr<Fwg::Cfg> settings;
+  std::future<PipelineProfile> job;
+  std::atomic<int> runsDone = 0;
+  int runsTotal = 0;
+  PipelineProfile last;
+  bool hasProfile = false;
+
+  PipelineProfile measure(std::vector<int> indices);
+
+public:
+  // divisor of width and height
+  int scale = 4;
+  // runs per prefix
+  int repetitions = 3;
+
+  void start(const Fwg::Cfg &cfg);
+  // collects a finished profile, call once per frame
+  void poll();
+  bool running() const { return job.valid(); }
+  float progress() const;
+  // nullptr until the first profile finished
+  const PipelineProfile *profile() const;
+};
+
+} // namespace Fwg::UI
@@ -1,5 +1,6 @@
 #pragma once
 #include "FastWorldGenerator.h"
+#include "UI/Snapshots.h"
 #include <functional>
 #include <imgui.h>
 #include <string>
@@ -47,96 +48,96 @@ public:
   // Terrain Prerequisites
   // =========================================================================
 
-  static Prerequisite heightmap(const Terrain::TerrainData &terrainData) {
+  static Prerequisite heightmap(const Snapshots::Summary &data) {
     return {"Heightmap", "Generate or load a heightmap first",
-            [&]() { return !terrainData.detailedHeightMap.empty(); }};
+            [&]() { return data.heightmap; }};
   }
 
-  static Prerequisite landMask(const Terrain::TerrainData &terrainData) {
+  static Prerequisite landMask(const Snapshots::Summary &data) {
     return {"Land mask", "Generate land/sea classification first",
-            [&]() { return !terrainData.landMask.empty(); }};
+            [&]() { return data.landMask; }};
   }
 
-  static Prerequisite landforms(const Terrain::TerrainData &terrainData) {
+  static Prerequisite landforms(const Snapshots::Summary &data) {
     return {"Landform classification", "Generate landform types first",
-            [&]() { return !terrainData.landFormIds.empty(); }};
+            [&]() { return data.landforms; }};
   }
 
-  static Prerequisite normalMap(const Terrain::TerrainData &terrainData) {
+  static Prerequisite normalMap(const Snapshots::Summary &data) {
     return {"Normal map", "Generate normal/sobel map first",
-            [&]() { return !terrainData.sobelData.empty(); }};
+            [&]() { return data.normalMap; }};
   }
 
   // =========================================================================
   // Climate Prerequisites
   // =========================================================================
 
-  static Prerequisite temperature(const Climate::ClimateData &climateData) {
+  static Prerequisite temperature(const Snapshots::Summary &data) {
     return {"Temperature data", "Generate temperature map first",
-            [&]() { return !climateData.averageTemperatures.empty(); }};
+            [&]() { return data.temperature; }};
   }
 
-  static Prerequisite humidity(const Climate::ClimateData &climateData) {
+  static Prerequisite humidity(const Snapshots::Summary &data) {
     return {"Humidity data", "Generate humidity map first",
-            [&]() { return !climateData.humidities.empty(); }};
+            [&]() { return data.humidity; }};
   }
 
-  static Prerequisite climate(const Climate::ClimateData &climateData) {
+  static Prerequisite climate(const Snapshots::Summary &data) {
     return {"Climate zones", "Generate climate classification first",
-            [&]() { return !climateData.climateChances.empty(); }};
+            [&]() { return data.climate; }};
   }
 
-  static Prerequisite habitability(const Climate::ClimateData &climateData) {
+  static Prerequisite habitability(const Snapshots::Summary &data) {
     return {"Habitability data", "Generate habitability/density map first",
-            [&]() { return !climateData.habitabilities.empty(); }};
+            [&]() { return data.habitability; }};
   }
 
   // =========================================================================
   // Area Prerequisites
   // =========================================================================
 
-  static Prerequisite segments(const Areas::AreaData &areaData) {
+  static Prerequisite segments(const Snapshots::Summary &data) {
     return {"Segments", "Generate segments first",
-            [&]() { return !areaData.segments.empty(); }};
+            [&]() { return data.segments; }};
   }
 
-  static Prerequisite superSegments(const Areas::AreaData &areaData) {
+  static Prerequisite superSegments(const Snapshots::Summary &data) {
     return {"Super segments", "Generate super segments first",
-            [&]() { return !areaData.superSegments.empty(); }};
+            [&]() { return data.superSegments; }};
   }
 
-  static Prerequisite provinces(const Areas::AreaData &areaData) {
+  static Prerequisite provinces(const Snapshots::Summary &data) {
     return {"Provinces", "Generate provinces first",
-            [&]() { return !areaData.provinces.empty(); }};
+            [&]() { return data.provinces; }};
   }
 
-  static Prerequisite regions(const Areas::AreaData &areaData) {
+  static Prerequisite regions(const Snapshots::Summary &data) {
     return {"Regions", "Generate regions first",
-            [&]() { return !areaData.regions.empty(); }};
+            [&]() { return data.regions; }};
   }
 
-  static Prerequisite landBodies(const Areas::AreaData &areaData) {
+  static Prerequisite landBodies(const Snapshots::Summary &data) {
     return {"Land bodies", "Generate land body detection first",
-            [&]() { return !areaData.landBodies.empty(); }};
+            [&]() { return data.landBodies; }};
   }
 
-  static Prerequisite continents(const Areas::AreaData &areaData) {
+  static Prerequisite continents(const Snapshots::Summary &data) {
     return {"Continents", "Generate continents first",
-            [&]() { return !areaData.continents.empty(); }};
+            [&]() { return data.continents; }};
   }
 
   // =========================================================================
   // Image Prerequisites
   // =========================================================================
 
-  static Prerequisite worldMap(const Gfx::Image &worldMap) {
+  static Prerequisite worldMap(const Snapshots::Summary &data) {
     return {"World map", "Generate world map visualization first",
-            [&]() { return worldMap.initialised(); }};
+            [&]() { return data.worldMap; }};
   }
 
-  static Prerequisite provinceMap(const Gfx::Image &provinceMap) {
+  static Prerequisite provinceMap(const Snapshots::Summary &data) {
     return {"Province map", "Generate province map first",
-            [&]() { return provinceMap.initialised(); }};
+            [&]() { return data.provinceMap; }};
   }
 
   // =========================================================================
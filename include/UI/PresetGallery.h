@@ -0,0 +1,45 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/HeightmapPresets.h"
+#include "UI/JobGrid.h"
+#include "UI/UIUtils.h"
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI {
+
+// Small heightmaps of every preset, applied on top of the current config.
+// Renders run in the background and are kept on disk, keyed by the heightmap
+// inputs after the preset was applied, so they survive restarts and unchanged
+// presets are never rendered twice.
+class PresetGallery {
+  struct Entry {
+    // the config with the preset applied, at gallery size
+    std::shared_ptr<const Fwg::Cfg> settings;
+    // heightmap inputs of settings and of the last started render
+    std::size_t inputs = 0;
+    std::size_t request = 0;
+    GLuint texture = 0;
+    std::future<Fwg::Gfx::Image> job;
+  };
+
+  std::map<std::string, Entry> entries;
+  std::string cacheFolder;
+  // heightmap inputs of the live config and catalog version entries use
+  std::size_t inputs = 0;
+
+public:
+  static constexpr int width = 256;
+  static constexpr int height = 128;
+
+  ~PresetGallery();
+  // uploads finished renders and starts missing ones, call once per frame
+  void update(const Fwg::Cfg &cfg, const HeightmapPresets &presets);
+  // 0 while the preset is being rendered
+  GLuint texture(const std::string &path) const;
+};
+
+} // namespace Fwg::UI
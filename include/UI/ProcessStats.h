@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+namespace Fwg::UI {
+
+// Resource use of the whole process at one point in time, zero where the
+// platform gives no answer
+struct ProcessSample {
+  std::size_t residentBytes = 0;
+  int threads = 0;
+};
+
+ProcessSample sampleProcess();
+
+} // namespace Fwg::UI
@@ -0,0 +1,72 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::Progress {
+
+// What the UI shows for one running job
+struct JobStatus {
+  int id;
+  std::string jobName;
+  // the running stages, comma separated
+  std::string stageName;
+  // number of finished stages
+  int stageIndex;
+  int stageCount;
+  float fraction;
+  double elapsedSeconds;
+  // negative if there is no history for one of the remaining stages
+  double etaSeconds;
+};
+
+// Collects stage progress from worker jobs. Stage durations are remembered per
+// resolution, so later runs at the same map size get an ETA and a smooth
+// per-stage fraction even though the stages themselves don't report progress.
+// Stages of a job may overlap, the ETA assumes the rest runs one at a time.
+class ProgressTracker {
+  using Clock = std::chrono::steady_clock;
+  struct Job {
+    std::string name;
+    std::vector<std::string> stages;
+    long long resolution;
+    // stage index -> start of the running stages
+    std::map<int, Clock::time_point> running;
+    std::vector<bool> finished;
+    int finishedCount = 0;
+    Clock::time_point jobStart;
+  };
+
+  mutable std::mutex mutex;
+  std::map<int, Job> jobs;
+  int nextJobId = 0;
+  // "stage|resolution" -> smoothed duration in seconds
+  std::map<std::string, double> history;
+  std::string historyFile;
+  std::string lastSummary;
+
+  static std::string historyKey(const std::string &stage,
+                                long long resolution);
+  double lookup(const std::string &stage, long long resolution) const;
+
+public:
+  int beginJob(const std::string &name, const std::vector<std::string> &stages,
+               long long resolution);
+  void beginStage(int jobId, int stageIndex);
+  // records the duration of the stage in the history
+  void endStage(int jobId, int stageIndex);
+  void endJob(int jobId);
+  std::vector<JobStatus> status() const;
+  // negative if the stage never ran at this resolution
+  double expectedSeconds(const std::string &stage, long long resolution) const;
+  // a line about the last finished job, e.g. its critical path
+  void setSummary(const std::string &summary);
+  std::string summary() const;
+
+  void loadHistory(const std::string &path);
+  void saveHistory() const;
+};
+
+} // namespace Fwg::UI::Progress
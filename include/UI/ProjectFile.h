@@ -0,0 +1,114 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/GenerationStages.h"
+#include "UI/MappedFile.h"
+#include "UI/Staleness.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Fwg::UI::Project {
+
+// Binary container of named chunks. A header points to a table of contents
+// at the end of the file, which lists the offset, size and element size of
+// every chunk. Values are stored in native byte order.
+struct Chunk {
+  std::uint64_t offset = 0;
+  std::uint64_t bytes = 0;
+  std::uint32_t elementSize = 1;
+};
+
+class Writer {
+  std::ofstream file;
+  std::string path;
+  std::vector<std::pair<std::string, Chunk>> toc;
+
+public:
+  bool open(const std::string &path);
+  void add(const std::string &name, const void *data, std::size_t bytes,
+           std::size_t elementSize);
+  template <typename T>
+  void add(const std::string &name, const std::vector<T> &values) {
+    static_assert(std::is_trivially_copyable_v<T>);
+    add(name, values.data(), values.size() * sizeof(T), sizeof(T));
+  }
+  // writes the table of contents, false if any write failed
+  bool finish();
+};
+
+class Reader {
+  MappedFile file;
+  std::map<std::string, Chunk> toc;
+
+public:
+  bool open(const std::string &path);
+  bool contains(const std::string &name) const { return toc.contains(name); }
+  // false if the chunk is missing or holds other elements
+  template <typename T>
+  bool read(const std::string &name, std::vector<T> &values) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    const auto entry = toc.find(name);
+    if (entry == toc.end() || entry->second.elementSize != sizeof(T)) {
+      return false;
+    }
+    values.resize(entry->second.bytes / sizeof(T));
+    if (!values.empty()) {
+      std::memcpy(values.data(), file.data() + entry->second.offset,
+                  values.size() * sizeof(T));
+    }
+    return true;
+  }
+};
+
+// Groups of chunks. The generator parts are copied into the generator, the
+// input parts into the classification state of their tab.
+enum class Part { TERRAIN, CLIMATE, AREAS, LAND_INPUT, CLIMATE_INPUT };
+
+// input colours and the classification picked for them
+using Mapping = std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>;
+
+// a copy of an input, as the UI may replace it while the project is written
+struct Input {
+  Fwg::Gfx::Image image;
+  Mapping mapping;
+};
+
+// Writes the generator data, including the noise layers lean memory holds,
+// the Cfg as json and both classification inputs. The area stages keep their
+// objects in pointer graphs, only their maps are stored.
+bool save(const std::string &path, const Fwg::Cfg &cfg,
+          const Fwg::FastWorldGenerator &fwg, const Input &landInput,
+          const Input &climateInput);
+
+// An opened project, whose parts are copied out of the mapped file once they
+// are needed
+class Session {
+  mutable std::mutex mutex;
+  std::shared_ptr<const Reader> reader;
+  std::set<Part> pendingParts;
+
+  // drops the mapping once every part was taken
+  void taken(Part part);
+
+public:
+  // reads the table of contents and the Cfg
+  bool open(const std::string &path, Fwg::Cfg &cfg);
+  bool pending(Part part) const;
+  // the pending generator parts, the preferred one first
+  std::vector<Part> generatorParts(Part preferred) const;
+  // copies a generator part and marks the stages it restored as loaded
+  bool materialise(Part part, Fwg::FastWorldGenerator &fwg,
+                   Stages::StalenessTracker &staleness);
+  // the image and classification of an input part
+  bool input(Part part, Fwg::Gfx::Image &image, Mapping &mapping);
+};
+
+} // namespace Fwg::UI::Project
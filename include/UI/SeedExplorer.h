@@ -0,0 +1,33 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/JobGrid.h"
+#include <vector>
+
+namespace Fwg::UI {
+
+// Generates the land of many seeds at a reduced resolution, each on a
+// generator of its own, a few at a time
+class SeedExplorer {
+public:
+  struct Cell : GridCell {
+    int seed = 0;
+  };
+
+private:
+  JobGrid<Cell> cells;
+
+public:
+  int count = 12;
+  // divisor of the map size for the explored worlds
+  int scale = 8;
+  bool randomSeeds = false;
+
+  // replaces the grid with count seeds after the current one
+  void start(const Fwg::Cfg &cfg);
+  // uploads finished worlds and starts waiting ones, call once per frame
+  void update();
+  const std::vector<Cell> &grid() const { return cells.all(); }
+  bool running() const { return cells.running(); }
+};
+
+} // namespace Fwg::UI
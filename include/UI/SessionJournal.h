@@ -0,0 +1,78 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/Drops.h"
+#include "UI/GenerationStages.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Fwg::UI::Journal {
+
+enum class Action { JOB, LOAD, FIELD, SEED, CLASSIFY, ANALYSE };
+
+struct Entry {
+  // since the recording started
+  double seconds = 0.0;
+  Action action;
+  // JOB: stage ids;concurrent;job name, LOAD: target;option;path,
+  // FIELD: path=value, SEED: seed, CLASSIFY: input target;r,g,b>r,g,b
+  // pairs separated by ;, ANALYSE: input target;generated
+  std::string detail;
+};
+
+// Journals the actions of a session that matter for its performance. Jobs
+// record from their own threads, so every method locks.
+class Recorder {
+  using Clock = std::chrono::steady_clock;
+  mutable std::mutex mutex;
+  bool active = false;
+  Clock::time_point start;
+  std::vector<Entry> entries;
+  // the Cfg fields at the last recorded edit
+  std::map<std::string, std::string> fields;
+  int seed = 0;
+  void watchLocked(const Fwg::Cfg &cfg);
+
+public:
+  // starts a new journal with the current seed and Cfg fields, so a replay
+  // begins from the same state
+  void begin(const Fwg::Cfg &cfg);
+  void end();
+  bool recording() const;
+  std::size_t size() const;
+  void record(Action action, const std::string &detail);
+  void recordJob(const std::string &jobName,
+                 const std::vector<Stages::Stage> &stages, bool concurrent);
+  void recordClassification(
+      Drops::Target input,
+      const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+          &mapping);
+  void recordDrop(const Drops::Drop &drop);
+  // an analysis of the land or climate input, generated is set if it
+  // generated the heightmap from the classified input
+  void recordAnalysis(Drops::Target input, bool generated);
+  // records the seed and the Cfg fields of ConfigFields::flatten that
+  // changed since the last call, call while no widget is being edited
+  void watch(const Fwg::Cfg &cfg);
+  // one entry per line, seconds|action|detail
+  bool save(const std::string &path) const;
+};
+
+bool load(const std::string &path, std::vector<Entry> &entries);
+
+struct Latency {
+  Entry entry;
+  double seconds = 0.0;
+  bool finished = true;
+};
+
+// Runs the journal again on the given generator, without a window, and
+// measures every action on its own
+std::vector<Latency> replay(const std::vector<Entry> &entries, Fwg::Cfg &cfg,
+                            Fwg::FastWorldGenerator &fwg);
+bool writeReport(const std::string &path,
+                 const std::vector<Latency> &latencies);
+
+} // namespace Fwg::UI::Journal
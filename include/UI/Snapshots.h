@@ -0,0 +1,74 @@
+#pragma once
+#include "FastWorldGenerator.h"
+#include "UI/GenerationStages.h"
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace Fwg::UI::Snapshots {
+
+// Which generator data exists and how large it is, everything the
+// prerequisite checks and statistics need
+struct Summary {
+  bool heightmap = false;
+  bool landMask = false;
+  bool landforms = false;
+  bool normalMap = false;
+  bool temperature = false;
+  bool humidity = false;
+  bool climate = false;
+  bool habitability = false;
+  bool superSegments = false;
+  bool segments = false;
+  bool provinces = false;
+  bool regions = false;
+  bool landBodies = false;
+  bool continents = false;
+  bool worldMap = false;
+  bool provinceMap = false;
+  int riverCount = 0;
+  int landSegments = 0;
+  int seaSegments = 0;
+  int lakeSegments = 0;
+  int provinceCount = 0;
+  int regionCount = 0;
+  int continentCount = 0;
+
+  bool operator==(const Summary &) const = default;
+};
+
+// reads everything, so only for generators no job is writing to
+Summary summarize(const Fwg::FastWorldGenerator &fwg);
+
+// Immutable state published for the UI thread. Images are only copied by
+// the stage that wrote them and shared between versions otherwise.
+struct DataView {
+  Summary summary;
+  std::shared_ptr<const Fwg::Gfx::Image> segmentMap;
+  std::shared_ptr<const Fwg::Gfx::Image> errorMap;
+  std::shared_ptr<const Fwg::Gfx::Image> provinceMap;
+  unsigned long long version = 0;
+};
+
+// the map of the view a stage wrote, null if the view holds none of its maps
+std::shared_ptr<const Fwg::Gfx::Image> stageMap(const DataView &view,
+                                                Stages::StageId stage);
+
+// Jobs publish a new view after every finished stage, the UI thread reads the
+// newest one without locking and never touches data a job is writing
+class Channel {
+  std::atomic<std::shared_ptr<const DataView>> current{
+      std::make_shared<const DataView>()};
+  // publishers copy the current view, so they are serialised
+  std::mutex publishMutex;
+
+public:
+  // only reads the data the finished stage wrote, returns the new view
+  std::shared_ptr<const DataView> publish(const Fwg::FastWorldGenerator &fwg,
+                                          Stages::StageId stage);
+  // reads everything, only call while no job runs
+  void publishSummary(const Fwg::FastWorldGenerator &fwg);
+  std::shared_ptr<const DataView> read() const { return current.load(); }
+};
+
+} // namespace Fwg::UI::Snapshots
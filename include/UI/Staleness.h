@@ -0,0 +1,61 @@
+#pragma once
+#include "UI/GenerationStages.h"
+#include <map>
+#include <mutex>
+#include <set>
+
+namespace Fwg::UI::Stages {
+
+// Remembers with which inputs each stage last produced its data. A stage is
+// stale if the Cfg fields it reads changed since, or if any stage it depends
+// on was recomputed, loaded or is stale itself. Stages that never ran are
+// missing rather than stale, the prerequisite checks handle those. The tabs
+// ask every frame, so their answers are kept until a stage is recorded or
+// refresh() finds that the inputs of a stage changed.
+class StalenessTracker {
+  struct Record {
+    bool computed = false;
+    // loaded data doesn't come from the Cfg, so only upstream changes count
+    bool loaded = false;
+    std::size_t inputHash = 0;
+    unsigned long long version = 0;
+    std::map<StageId, unsigned long long> upstreamVersions;
+  };
+
+  mutable std::mutex mutex;
+  std::map<StageId, Record> records;
+  unsigned long long nextVersion = 1;
+  mutable std::set<StageId> cachedStale;
+  mutable bool cacheValid = false;
+  // the input hashes of all stages at the last refresh
+  std::vector<std::size_t> lastInputs;
+
+  void update(StageId id, bool loaded, std::size_t inputHash);
+  // one pass over all stages, dependencies come first in StageId order
+  std::set<StageId> computeStale(const Fwg::Cfg &cfg) const;
+  const std::set<StageId> &cached(const Fwg::Cfg &cfg) const;
+
+public:
+  // inputHash has to be taken before the stage ran, the Cfg may change while
+  // it runs
+  void markComputed(StageId id, std::size_t inputHash);
+  // for data dropped in or loaded from a file
+  void markLoaded(StageId id);
+  // for data that was dropped, the stage counts as missing again
+  void forget(StageId id);
+  void clear();
+  // the Cfg may have changed, e.g. a widget was released
+  void invalidate();
+  // hashes the inputs of all stages and invalidates if any of them changed,
+  // whatever changed the Cfg. Called once per frame.
+  void refresh(const Fwg::Cfg &cfg);
+  bool isStale(StageId id, const Fwg::Cfg &cfg) const;
+  // all stale stages, in dependency order
+  std::vector<StageId> staleIds(const Fwg::Cfg &cfg) const;
+  // the stale stages among the candidates, in dependency order, always
+  // checked against the current Cfg
+  std::vector<Stage> staleStages(const Fwg::Cfg &cfg,
+                                 const std::vector<Stage> &candidates) const;
+};
+
+} // namespace Fwg::UI::Stages
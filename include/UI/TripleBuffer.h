@@ -0,0 +1,41 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+namespace Fwg::UI {
+
+// Lock-free channel between one producer and one consumer that only cares
+// about the newest value. The producer fills its own slot and swaps it with
+// the shared middle slot, the consumer swaps the middle slot with its own
+// when a new value arrived. Neither side ever waits or sees a half-written
+// value, older frames are dropped.
+template <typename T> class TripleBuffer {
+  static constexpr int fresh = 4;
+  std::array<T, 3> slots;
+  // index of the middle slot, with the fresh bit set while it is unread
+  std::atomic<int> middle = 1;
+  // owned by the producer
+  int writeIndex = 0;
+  // owned by the consumer
+  int readIndex = 2;
+
+public:
+  // producer side
+  T &writeBuffer() { return slots[writeIndex]; }
+  void publish() {
+    writeIndex =
+        middle.exchange(writeIndex | fresh, std::memory_order_acq_rel) & ~fresh;
+  }
+
+  // consumer side, returns true if a newer value is now in readBuffer()
+  bool update() {
+    if (!(middle.load(std::memory_order_relaxed) & fresh)) {
+      return false;
+    }
+    readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & ~fresh;
+    return true;
+  }
+  T &readBuffer() { return slots[readIndex]; }
+};
+
+} // namespace Fwg::UI
@@ -3,10 +3,21 @@
 #define GLFW_INCLUDE_NONE
 #include "FastWorldGenerator.h"
 #include "GLFW/glfw3.h"
+#include "UI/Cancellation.h"
+#include "UI/Drops.h"
+#include "UI/EditHistory.h"
+#include "UI/GenerationStages.h"
+#include "UI/Progress.h"
+#include "UI/SessionJournal.h"
+#include "UI/Snapshots.h"
+#include "UI/Staleness.h"
+#include "UI/TripleBuffer.h"
 #include "UI/UIUtils.h"
 #include "UI/UiElements.h"
 #include "utils/Cfg.h"
+#include <array>
 #include <map>
+#include <memory>
 
 namespace Fwg::UI {
 namespace Drawing {
@@ -27,9 +38,12 @@ struct DrawContext {
 };
 } // namespace Drawing
 
+// shown images are immutable and shared with their producers where possible
+using ImageHandle = std::shared_ptr<const Fwg::Gfx::Image>;
+
 struct ImageContext {
 
-  std::array<Fwg::Gfx::Image, 2> activeImages;
+  std::array<ImageHandle, 2> activeImages;
   // ui state
   GLuint primaryTexture = 0;
   GLuint secondaryTexture = 0;
@@ -65,29 +79,72 @@ struct ImageContext {
     resetTexture(1);
   }
 
+  // the shown image, an empty one if nothing was shown yet
+  const Fwg::Gfx::Image &activeImage(int index) const {
+    static const Fwg::Gfx::Image empty;
+    return activeImages[index] ? *activeImages[index] : empty;
+  }
+
+  // shows the newest streamed frame, if one arrived since the last call. The
+  // frame is taken out of the channel, its pixels are shared, not copied.
+  void showLivePreview(TripleBuffer<ImageHandle> &channel) {
+    if (channel.update()) {
+      updateImage(0, ImageHandle(std::move(channel.readBuffer())));
+    }
+  }
+
+  // the caller keeps its image, so it is copied, unless the other view
+  // already shows the same pixels
   void updateImage(int index, const Fwg::Gfx::Image &image) {
+    const auto &other = activeImages[1 - index];
+    if (other && other->width() == image.width() &&
+        other->height() == image.height() &&
+        other->imageData == image.imageData) {
+      updateImage(index, other);
+      return;
+    }
+    updateImage(index, std::make_shared<const Fwg::Gfx::Image>(image));
+  }
+
+  void updateImage(int index, Fwg::Gfx::Image &&image) {
+    updateImage(index,
+                std::make_shared<const Fwg::Gfx::Image>(std::move(image)));
+  }
+
+  void updateImage(int index, const ImageHandle &image) {
     GLuint &texture = (index == 0) ? primaryTexture : secondaryTexture;
+    const GLuint otherTexture =
+        (index == 0) ? secondaryTexture : primaryTexture;
     bool &updateFlag = (index == 0) ? updateTexture1 : updateTexture2;
 
-    // Free existing GL texture
-    Fwg::UI::Utils::freeTexture(&texture);
+    // Free existing GL texture, unless the other view shares it
+    if (texture != otherTexture) {
+      Fwg::UI::Utils::freeTexture(&texture);
+    }
+    texture = 0;
     updateFlag = false;
 
-    if (!image.initialised() || image.imageData.empty())
+    if (!image || !image->initialised() || image->imageData.empty())
       return;
 
     try {
       activeImages[index] = image;
 
+      // the same image in both views is uploaded once
+      if (otherTexture && activeImages[1 - index] == image) {
+        texture = otherTexture;
+        return;
+      }
+
       // Upload OpenGL texture
-      if (!Fwg::UI::Utils::getResourceView(image, &texture, &textureWidth,
+      if (!Fwg::UI::Utils::getResourceView(*image, &texture, &textureWidth,
                                            &textureHeight)) {
         Fwg::Utils::Logging::logLine("ERROR: Couldn't create OpenGL texture");
         return;
       }
 
-      textureWidth = image.width();
-      textureHeight = image.height();
+      textureWidth = image->width();
+      textureHeight = image->height();
     } catch (const std::exception &e) {
       Fwg::Utils::Logging::logLine(
           std::string("ERROR: Exception in updateImage: ") + e.what());
@@ -101,6 +158,8 @@ struct HelpContext {
   std::map<std::string, Fwg::Gfx::Image> advancedHelpImages;
   std::map<std::string, float> advancedHelpTexturesAspectRatio;
   std::map<std::string, GLuint> advancedHelpTextures;
+  // width and height of each uploaded texture, the images aren't kept
+  std::map<std::string, std::pair<int, int>> advancedHelpTextureSizes;
   std::string activeKey = "";
   bool showExtendedHelp = false;
 
@@ -160,6 +219,7 @@ struct HelpContext {
         continue;
 
       advancedHelpTextures[filename] = texture;
+      advancedHelpTextureSizes[filename] = {w, h};
       advancedHelpTexturesAspectRatio[filename] = float(h) / float(w);
     }
   }
@@ -314,17 +374,52 @@ struct AsyncContext {
   std::atomic<bool> computationRunning;
   std::atomic<bool> computationStarted;
   std::future<bool> computationFutureBool;
+  // polled by cancellable jobs, set by the cancel button
+  CancellationToken cancellation;
+  Progress::ProgressTracker progress;
+  // which stages ran with which inputs, filled by finished jobs
+  Stages::StalenessTracker staleness;
+  // what the UI may read while a job writes the generator data
+  Snapshots::Channel snapshots;
+  // the maps stages of a running job finished
+  TripleBuffer<ImageHandle> livePreview;
+  // actions of the session, while recording
+  Journal::Recorder journal;
+
+  Stages::RunOptions runOptions(const std::string &jobName,
+                                bool resetData = false) {
+    Stages::RunOptions options{jobName, &cancellation, &progress, resetData};
+    options.staleness = &staleness;
+    options.snapshots = &snapshots;
+    options.livePreview = &livePreview;
+    options.journal = &journal;
+    return options;
+  }
+
+  // journals a dropped file and loads it the way its tab does
+  bool loadDrop(const Drops::Drop &drop, Fwg::Cfg &cfg,
+                Fwg::FastWorldGenerator &fwg, Fwg::Gfx::Image &input) {
+    journal.recordDrop(drop);
+    return Drops::load(drop, cfg, fwg, input);
+  }
+  bool loadDrop(const Drops::Drop &drop, Fwg::Cfg &cfg,
+                Fwg::FastWorldGenerator &fwg) {
+    Fwg::Gfx::Image input;
+    return loadDrop(drop, cfg, fwg, input);
+  }
 
   // Function wrapper to run any function asynchronously
   template <typename Func, typename... Args>
   auto runAsync(Func func, Args &...args) {
     computationStarted = true;
     computationRunning = true;
+    cancellation.reset();
     return std::async(std::launch::async, func, std::ref(args)...);
   }
   template <typename Func, typename... Args>
   auto runAsyncInitialDisable(Func func, Args &...args) {
     computationRunning = true;
+    cancellation.reset();
     return std::async(std::launch::async, func, std::ref(args)...);
   }
 };
@@ -336,8 +431,10 @@ struct LayoutContext {
 struct GenerationContext {
   bool analyze = false;
   int amountClassificationsNeeded = 0;
-  bool redoHumidity = false;
   bool modifiedAreas = false;
+  // lets the graph scheduler overlap isolated stages with the others, off by
+  // default as most stages share the generator's data and random engine
+  bool concurrentStages = false;
 };
 struct ClimateInput {
   Fwg::Gfx::Colour in;
@@ -353,6 +450,8 @@ struct ClimateUiContext {
   int amountClassificationsNeeded = 0;
   std::set<Fwg::Gfx::Colour> highlightedInputs;
   Fwg::Gfx::Image climateInputMap;
+  // undo and redo of the classification applies on the climate input
+  EditHistory inputHistory;
   Fwg::Utils::ColourTMap<ClimateInput> climateInputColours;
   Fwg::Utils::ColourTMap<Fwg::Climate::ClimateClassDefinition>
       allowedClimateInputs;
@@ -369,13 +468,33 @@ struct UIContext {
 
   std::string draggedFile = "";
   bool triggeredDrag = false;
+  // the published data the tabs read during this frame
+  std::shared_ptr<const Snapshots::DataView> dataView =
+      std::make_shared<const Snapshots::DataView>();
+
+  // called once per frame before the tabs are drawn. Without a running job
+  // the generator data is safe to read, so the summary is taken from it.
+  void refreshDataView(const Fwg::FastWorldGenerator &fwg) {
+    if (!asyncContext.computationRunning) {
+      asyncContext.snapshots.publishSummary(fwg);
+    }
+    dataView = asyncContext.snapshots.read();
+  }
+  const Snapshots::Summary &summary() const { return dataView->summary; }
+  // highlights the tab of a stage whose data is outdated
+  bool staleTab(Stages::StageId id, const Fwg::Cfg &cfg) const {
+    return asyncContext.staleness.isStale(id, cfg);
+  }
+  // The tabs draw their images from the generator data, which the UI thread
+  // only reads while no job writes it. A switch during a job is handled once
+  // the job finished and reset the textures.
   bool tabSwitchEvent(const bool processClickEvents = false) {
     this->drawContext.processClickEvents = processClickEvents;
     if (ImGui::IsMouseReleased(0) && ImGui::IsItemHovered()) {
       imageContext.resetTexture();
-      return true;
     }
-    return imageContext.updateTexture1 || imageContext.updateTexture2;
+    return !asyncContext.computationRunning &&
+           (imageContext.updateTexture1 || imageContext.updateTexture2);
   }
 };
 
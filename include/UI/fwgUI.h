@@ -4,11 +4,21 @@
 #include "HeightmapUI.h"
 #include "LandUI.h"
 #include "UI/AreaUI.h"
+#include "UI/ColdLayers.h"
 #include "UI/DrawUtils.h"
+#include "UI/GenerationStages.h"
+#include "UI/HeightmapCache.h"
+#include "UI/LayerFields.h"
+#include "UI/MemoryLedger.h"
+#include "UI/ParameterSweep.h"
 #include "UI/PreRequisites.h"
+#include "UI/ProcessStats.h"
+#include "UI/ProjectFile.h"
+#include "UI/SeedExplorer.h"
 #include "UI/UIContext.h"
 #include "UI/UiElements.h"
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <string>
@@ -25,15 +35,32 @@ protected:
   std::shared_ptr<std::stringstream> log;
   Fwg::UI::UIContext uiContext;
   Fwg::UI::HeightmapUI heightmapUI;
+  Fwg::UI::SeedExplorer seedExplorer;
+  Fwg::UI::ParameterSweep parameterSweep;
+  Fwg::UI::Memory::Ledger memoryLedger;
+  // the memory tab warns above this
+  int memoryBudgetMb = 4096;
+  // the memory tab samples the process about once a second
+  UI::ProcessSample processSample;
+  std::chrono::steady_clock::time_point processSampled;
   LandUI landUI;
+  // an opened project copies the part of the shown tab first
+  UI::Project::Session project;
+  UI::Project::Part shownPart = UI::Project::Part::TERRAIN;
+  // a dropped project, opened once no job runs
+  std::string pendingProject;
+  // a dropped input, handed to the shown tab once no job runs, as the tabs
+  // load it into the generator right away
+  std::string pendingDrop;
+  // the file the project buttons save to and open
+  char projectPath[512] = "";
 
   void writeCurrentlyDisplayedImage(Fwg::Cfg &cfg) {
-    if (uiContext.imageContext.activeImages[0].size() &&
-        uiContext.imageContext.activeImages[0].size()) {
+    const auto &activeImage = uiContext.imageContext.activeImage(0);
+    if (activeImage.size()) {
       std::string path = cfg.mapsPath + "/";
       path += std::to_string(time(NULL));
-      Fwg::Gfx::Png::save(uiContext.imageContext.activeImages[0],
-                          path + ".png");
+      Fwg::Gfx::Png::save(activeImage, path + ".png");
     }
   }
 
@@ -51,6 +78,14 @@ protected:
   int showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg);
 
   int showAreasTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg);
+  int showSeedExplorer(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg);
+  int showParameterSweep(Fwg::Cfg &cfg);
+  int showMemoryTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg);
+  void initMemoryLedger(Fwg::FastWorldGenerator &fwg);
+  void saveProject(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                   const std::string &path);
+  bool openProject(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                   const std::string &path);
 
 protected:
   void genericWrapper(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg);
@@ -1,6 +1,7 @@
 #pragma once
 #include "FastWorldGenerator.h"
 #include "UI/DrawUtils.h"
+#include "UI/EditHistory.h"
 #include "UI/InputUI.h"
 #include "UI/UIUtils.h"
 #include "backends/imgui_impl_dx11.h"
@@ -26,13 +27,30 @@ private:
       std::vector<Fwg::Gfx::Colour> &imageData,
       const std::vector<Fwg::Terrain::LandformDefinition> &landformDefinitions,
       UI::UIContext &uiContext);
-  bool analyseLandMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
-                      const Fwg::Gfx::Image &landInput,
-                      int &amountClassificationsNeeded);
 
 public:
   LandUI();
+  bool analyseLandMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                      const Fwg::Gfx::Image &landInput,
+                      int &amountClassificationsNeeded);
+  // sets a land input from a project together with its pending
+  // classifications
+  void restoreInput(
+      Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+      const Fwg::Gfx::Image &image,
+      const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+      int &amountClassificationsNeeded);
+  // highlights every colour of mapping that the last analysis found, to be
+  // classified as its paired colour by the next apply
+  void setClassifications(
+      const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+          &mapping);
+  // applies the classification of every highlighted colour to the land
+  // input as one undoable edit, returns the applied colours
+  std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> applyHighlighted();
   Fwg::Gfx::Image landInput;
+  // undo and redo of the classification applies on the land input
+  UI::EditHistory inputHistory;
   std::string loadedTerrainFile;
   bool classificationNeeded = true;
   void complexLandMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
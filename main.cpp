@@ -3,6 +3,7 @@
 #pragma warning(disable : 4996)
 #include "FastWorldGenerator.h"
 #include "UI/FwgUI.h"
+#include "UI/Headless.h"
 #include "utils/Logging.h"
 #include "utils/Utils.h"
 #include <filesystem>
@@ -24,7 +25,11 @@ void dumpInfo(const std::string &error, const std::string &configSubFolder) {
   Fwg::Parsing::writeFile("log.txt", dump);
 }
 
-int main() {
+int main(int argc, char *argv[]) {
+  Fwg::UI::Headless::Options headless;
+  if (!Fwg::UI::Headless::parseArguments(argc, argv, headless)) {
+    return -1;
+  }
   Fwg::Utils::Logging::logLine("Starting the config loading");
   // Short alias for this namespace
   namespace pt = boost::property_tree;
@@ -80,6 +85,11 @@ int main() {
     return -1;
   }
 
+  if (headless.enabled) {
+    // batch runs never open a window or touch OpenGL
+    return Fwg::UI::Headless::run(headless, config);
+  }
+
   Fwg::Utils::Logging::logLine("Initialising Fwg");
   Fwg::FastWorldGenerator fwg;
   Fwg::Utils::Logging::logLine("Initialising Fwg UI");
@@ -19,7 +19,8 @@ namespace Fwg::UI::Areas {
 
 int showDensityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                    UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Density")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Density", uiContext.staleTab(Stages::StageId::HABITABILITY, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       // pre-create density map, if not existing yet, so users see the default
       // map and can then decide to overwrite (or change parameters)
@@ -41,23 +42,27 @@ int showDensityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::climate(fwg.climateData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData)});
+        {UI::PrerequisiteChecker::climate(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton(
               "Generate Density from Climate Data", ImVec2(250, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genHabitability(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::HABITABILITY, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Density"));
               uiContext.imageContext.resetTexture(0);
-              return true;
+              return finished;
             });
       }
 
       if (uiContext.triggeredDrag) {
-        fwg.loadHabitability(
-            cfg, Fwg::IO::Reader::readGenericImage(uiContext.draggedFile, cfg));
+        uiContext.asyncContext.loadDrop(
+            {Drops::Target::HABITABILITY, uiContext.draggedFile}, cfg, fwg);
+        uiContext.asyncContext.staleness.markLoaded(
+            Stages::StageId::HABITABILITY);
         uiContext.imageContext.resetTexture(0);
         uiContext.triggeredDrag = false;
         uiContext.imageContext.resetTexture();
@@ -70,7 +75,9 @@ int showDensityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 }
 void showSuperSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                          UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("SuperSegments")) {
+  if (UI::Elements::BeginSubTabItem(
+          "SuperSegments",
+          uiContext.staleTab(Stages::StageId::SUPERSEGMENTS, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       if (fwg.worldMap.size()) {
         uiContext.imageContext.updateImage(
@@ -86,9 +93,9 @@ void showSuperSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::climate(fwg.climateData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::habitability(fwg.climateData)});
+        {UI::PrerequisiteChecker::climate(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::habitability(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::Button("Generate Template Images", false,
@@ -102,10 +109,12 @@ void showSuperSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       if (UI::Elements::ImportantStepButton("Generate SuperSegments",
                                             ImVec2(220, 0))) {
         uiContext.asyncContext.computationFutureBool =
-            uiContext.asyncContext.runAsync([&fwg, &cfg,  &uiContext]() {
-              fwg.genSuperSegments(cfg);
+            uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
+              const bool finished = Stages::runStage(
+                  Stages::StageId::SUPERSEGMENTS, cfg, fwg,
+                  uiContext.asyncContext.runOptions("SuperSegments"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
@@ -113,21 +122,11 @@ void showSuperSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.triggeredDrag = false;
-              auto evaluationAreas =
-                  Fwg::UI::Utils::Masks::getLandmaskEvaluationAreas(
-                      fwg.terrainData.landMask);
-              if (cfg.areaInputMode == Fwg::Areas::AreaInputType::SOLID) {
-                fwg.loadSuperSegments(
-                    cfg, Fwg::IO::Reader::readGenericImageWithBorders(
-                             uiContext.draggedFile, cfg, evaluationAreas));
-              } else {
-                auto image = Fwg::IO::Reader::readGenericImage(
-                    uiContext.draggedFile, cfg);
-                Fwg::Gfx::Filter::colouriseAreaBorderInputByBordersOnly(
-                    image, evaluationAreas);
-                Fwg::Gfx::Filter::fillBlackPixelsByArea(image, evaluationAreas);
-                fwg.loadSuperSegments(cfg, image);
-              }
+              uiContext.asyncContext.loadDrop(
+                  {Drops::Target::SUPERSEGMENTS, uiContext.draggedFile}, cfg,
+                  fwg);
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::SUPERSEGMENTS);
               uiContext.imageContext.resetTexture();
               return true;
             });
@@ -139,17 +138,19 @@ void showSuperSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 }
 void showSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                     UIContext &uiContext) {
-  static auto lastEvent = std::chrono::high_resolution_clock::now();
-
-  if (UI::Elements::BeginSubTabItem("Segments")) {
-    // check if 50ms have passed since last event
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(now - lastEvent);
-    if (uiContext.tabSwitchEvent() || duration.count() > 50) {
-      lastEvent = now;
-      uiContext.imageContext.updateImage(0, fwg.segmentMap);
-      uiContext.imageContext.updateImage(1, fwg.errorMap);
+  static unsigned long long shownVersion = 0;
+
+  if (UI::Elements::BeginSubTabItem(
+          "Segments", uiContext.staleTab(Stages::StageId::SEGMENTS, cfg))) {
+    // the maps are shown from the published view, jobs and loads publish a
+    // new one whenever they changed them
+    const auto &view = *uiContext.dataView;
+    const bool switched = uiContext.tabSwitchEvent();
+    if ((switched || view.version != shownVersion) &&
+        view.summary.segments && view.segmentMap) {
+      shownVersion = view.version;
+      uiContext.imageContext.updateImage(0, view.segmentMap);
+      uiContext.imageContext.updateImage(1, view.errorMap);
     }
     uiContext.helpContext.showHelpTextBox("Segments");
 
@@ -178,19 +179,20 @@ void showSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::climate(fwg.climateData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::habitability(fwg.climateData),
-         UI::PrerequisiteChecker::superSegments(fwg.areaData)});
+        {UI::PrerequisiteChecker::climate(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::habitability(uiContext.summary()),
+         UI::PrerequisiteChecker::superSegments(uiContext.summary())});
 
     if (guard.ready()) {
       ImGui::SeparatorText("Segment Statistics");
 
       {
         UI::Elements::GridLayout grid(3, 150.0f, 12.0f);
-        grid.AddText("Land Segments", "%d", (int)fwg.areaData.landSegments);
-        grid.AddText("Sea Segments", "%d", (int)fwg.areaData.seaSegments);
-        grid.AddText("Lake Segments", "%d", (int)fwg.areaData.lakeSegments);
+        const auto &summary = uiContext.summary();
+        grid.AddText("Land Segments", "%d", summary.landSegments);
+        grid.AddText("Sea Segments", "%d", summary.seaSegments);
+        grid.AddText("Lake Segments", "%d", summary.lakeSegments);
       }
 
       ImGui::Spacing();
@@ -208,9 +210,11 @@ void showSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.generationContext.modifiedAreas = true;
-              fwg.genSegments(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::SEGMENTS, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Segments"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
@@ -218,23 +222,14 @@ void showSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.triggeredDrag = false;
-              const auto evaluationAreas =
-                  Fwg::UI::Utils::Masks::getLandmaskEvaluationAreas(
-                      fwg.terrainData.landMask);
-              if (cfg.areaInputMode == Fwg::Areas::AreaInputType::SOLID) {
-                fwg.loadSegments(
-                    cfg, Fwg::IO::Reader::readGenericImageWithBorders(
-                             uiContext.draggedFile, cfg, evaluationAreas));
-              } else {
-                auto image = Fwg::IO::Reader::readGenericImage(
-                    uiContext.draggedFile, cfg);
-                Fwg::Gfx::Filter::colouriseAreaBorderInputByBordersOnly(
-                    image, evaluationAreas);
-                Fwg::Gfx::Filter::fillBlackPixelsByArea(image, evaluationAreas);
-                fwg.loadSegments(cfg, image);
-              }
+              uiContext.asyncContext.loadDrop(
+                  {Drops::Target::SEGMENTS, uiContext.draggedFile}, cfg, fwg);
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::SEGMENTS);
               fwg.segmentMap =
                   Fwg::Gfx::Segments::displaySegments(fwg.areaData.segments);
+              uiContext.asyncContext.snapshots.publish(
+                  fwg, Stages::StageId::SEGMENTS);
               uiContext.imageContext.resetTexture();
               uiContext.generationContext.modifiedAreas = true;
               return true;
@@ -247,17 +242,19 @@ void showSegmentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 }
 int showProvincesTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                      UIContext &uiContext) {
-  static auto lastEvent = std::chrono::high_resolution_clock::now();
-
-  if (UI::Elements::BeginSubTabItem("Provinces")) {
-    // check if 50ms have passed since last event
-    auto now = std::chrono::high_resolution_clock::now();
-    auto duration =
-        std::chrono::duration_cast<std::chrono::milliseconds>(now - lastEvent);
-    if (uiContext.tabSwitchEvent() || duration.count() > 50) {
-      lastEvent = now;
-      uiContext.imageContext.updateImage(0, fwg.provinceMap);
-      uiContext.imageContext.updateImage(1, fwg.segmentMap);
+  static unsigned long long shownVersion = 0;
+
+  if (UI::Elements::BeginSubTabItem(
+          "Provinces", uiContext.staleTab(Stages::StageId::PROVINCES, cfg))) {
+    const auto &view = *uiContext.dataView;
+    const bool switched = uiContext.tabSwitchEvent();
+    if ((switched || view.version != shownVersion) &&
+        view.summary.provinceMap && view.provinceMap) {
+      shownVersion = view.version;
+      uiContext.imageContext.updateImage(0, view.provinceMap);
+      if (view.segmentMap) {
+        uiContext.imageContext.updateImage(1, view.segmentMap);
+      }
     }
     uiContext.helpContext.showHelpTextBox("Provinces");
 
@@ -273,16 +270,16 @@ int showProvincesTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       grid.AddInputInt("Min Province Size", &cfg.minProvSize, 9, 1000);
       grid.AddInputInt("Max Province Count", &cfg.maxProvAmount, 100, 100000);
       grid.AddText("Current Provinces", "%d",
-                   (int)fwg.areaData.provinces.size());
+                   uiContext.summary().provinceCount);
     }
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::climate(fwg.climateData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::habitability(fwg.climateData),
-         UI::PrerequisiteChecker::superSegments(fwg.areaData),
-         UI::PrerequisiteChecker::segments(fwg.areaData)});
+        {UI::PrerequisiteChecker::climate(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::habitability(uiContext.summary()),
+         UI::PrerequisiteChecker::superSegments(uiContext.summary()),
+         UI::PrerequisiteChecker::segments(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::Button("Generate Template Images", false,
@@ -299,7 +296,9 @@ int showProvincesTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         cfg.calcAreaParameters();
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              if (!fwg.genProvinces()) {
+              if (!Stages::runStage(
+                      Stages::StageId::PROVINCES, cfg, fwg,
+                      uiContext.asyncContext.runOptions("Provinces"))) {
                 return false;
               }
               uiContext.imageContext.resetTexture();
@@ -312,21 +311,12 @@ int showProvincesTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.generationContext.modifiedAreas = true;
               uiContext.triggeredDrag = false;
-              auto evaluationAreas =
-                  Fwg::UI::Utils::Masks::getLandmaskEvaluationAreas(
-                      fwg.terrainData.landMask);
-              if (cfg.areaInputMode == Fwg::Areas::AreaInputType::SOLID) {
-                fwg.loadProvinces(
-                    cfg, Fwg::IO::Reader::readGenericImageWithBorders(
-                             uiContext.draggedFile, cfg, evaluationAreas));
-              } else {
-                auto image = Fwg::IO::Reader::readGenericImage(
-                    uiContext.draggedFile, cfg);
-                Fwg::Gfx::Filter::colouriseAreaBorderInputByBordersOnly(
-                    image, evaluationAreas);
-                Fwg::Gfx::Filter::fillBlackPixelsByArea(image, evaluationAreas);
-                fwg.loadProvinces(cfg, image);
-              }
+              uiContext.asyncContext.loadDrop(
+                  {Drops::Target::PROVINCES, uiContext.draggedFile}, cfg, fwg);
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::PROVINCES);
+              uiContext.asyncContext.snapshots.publish(
+                  fwg, Stages::StageId::PROVINCES);
               uiContext.imageContext.resetTexture();
               return true;
             });
@@ -344,10 +334,10 @@ int showRegionTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     uiContext.helpContext.showHelpTextBox("Regions");
 
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::habitability(fwg.climateData),
-         UI::PrerequisiteChecker::provinceMap(fwg.provinceMap)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::habitability(uiContext.summary()),
+         UI::PrerequisiteChecker::provinceMap(uiContext.summary())});
 
     if (guard.ready()) {
       ImGui::SeparatorText("Generate a region map");
@@ -360,8 +350,7 @@ int showRegionTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
               return true;
             });
       }
-      ImGui::Text("The map has %i regions",
-                  static_cast<int>(fwg.areaData.regions.size()));
+      ImGui::Text("The map has %i regions", uiContext.summary().regionCount);
 
       if (uiContext.triggeredDrag) {
         if (fwg.provinceMap.initialised()) {
@@ -388,9 +377,10 @@ int showRegionTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
 int showContinentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                             UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Continents")) {
-    if (uiContext.tabSwitchEvent() && fwg.areaData.provinces.size() &&
-        fwg.areaData.regions.size()) {
+  if (UI::Elements::BeginSubTabItem(
+          "Continents", uiContext.staleTab(Stages::StageId::CONTINENTS, cfg))) {
+    if (uiContext.tabSwitchEvent() && uiContext.summary().provinces &&
+        uiContext.summary().regions) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::simpleContinents(fwg.areaData.continents,
                                         fwg.areaData.seaBodies));
@@ -405,29 +395,31 @@ int showContinentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       UI::Elements::GridLayout grid(2, 200.0f, 12.0f);
       grid.AddInputInt("Max Continents", &cfg.maxAmountOfContinents, 1, 50);
       grid.AddText("Current Continents", "%d",
-                   (int)fwg.areaData.continents.size());
+                   uiContext.summary().continentCount);
     }
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::climate(fwg.climateData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::habitability(fwg.climateData),
-         UI::PrerequisiteChecker::superSegments(fwg.areaData),
-         UI::PrerequisiteChecker::segments(fwg.areaData),
-         UI::PrerequisiteChecker::provinces(fwg.areaData)});
+        {UI::PrerequisiteChecker::climate(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::habitability(uiContext.summary()),
+         UI::PrerequisiteChecker::superSegments(uiContext.summary()),
+         UI::PrerequisiteChecker::segments(uiContext.summary()),
+         UI::PrerequisiteChecker::provinces(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate Continents",
                                             ImVec2(220, 0)) ||
-          (fwg.areaData.continents.empty() &&
+          (!uiContext.summary().continents &&
            !uiContext.asyncContext.computationRunning)) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.generationContext.modifiedAreas = true;
-              fwg.genContinents(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::CONTINENTS, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Continents"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
@@ -435,12 +427,11 @@ int showContinentTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
               uiContext.generationContext.modifiedAreas = true;
-              auto evaluationAreas =
-                  Fwg::UI::Utils::Masks::getLandmaskEvaluationAreas(
-                      fwg.terrainData.landMask);
-              fwg.loadContinents(
-                  cfg, Fwg::IO::Reader::readGenericImageWithBorders(
-                           uiContext.draggedFile, cfg, evaluationAreas));
+              uiContext.asyncContext.loadDrop(
+                  {Drops::Target::CONTINENTS, uiContext.draggedFile}, cfg,
+                  fwg);
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::CONTINENTS);
               uiContext.triggeredDrag = false;
               uiContext.imageContext.resetTexture();
               return true;
@@ -36,15 +36,21 @@ bool RenderScrollableClimateInput(std::vector<Fwg::Gfx::Colour> &imageData,
     ImGui::SameLine();
 
     if (ImGui::Button("Apply type to all selected")) {
+      std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> applied;
+      EditHistory::Edit edit(imageData);
       for (const auto &selId : selectedInputs) {
         if (uiContext.climateUI.climateInputColours.getMap().contains(selId)) {
           auto &entry =
               uiContext.climateUI.climateInputColours.getMap().at(selId);
           for (auto &pix : entry.pixels) {
-            imageData[pix] = entry.out;
+            edit.set(pix, entry.out);
           }
+          applied.emplace_back(entry.in, entry.out);
         }
       }
+      uiContext.climateUI.inputHistory.push(std::move(edit), "apply selected");
+      uiContext.asyncContext.journal.recordClassification(
+          Drops::Target::CLIMATE_INPUT, applied);
       uiContext.climateUI.highlightedInputs.clear();
       updated = true;
       selectedInputs.clear();
@@ -133,8 +139,13 @@ bool RenderScrollableClimateInput(std::vector<Fwg::Gfx::Colour> &imageData,
 
     // --- Apply single ---
     if (ImGui::Button(("Apply type for " + entry.in.toString()).c_str())) {
+      EditHistory::Edit edit(imageData);
       for (auto &pix : entry.pixels)
-        imageData[pix] = entry.out;
+        edit.set(pix, entry.out);
+      uiContext.climateUI.inputHistory.push(std::move(edit),
+                                            "apply " + entry.in.toString());
+      uiContext.asyncContext.journal.recordClassification(
+          Drops::Target::CLIMATE_INPUT, {{entry.in, entry.out}});
 
       uiContext.climateUI.highlightedInputs.erase(entry.in);
       updated = true;
@@ -240,6 +251,24 @@ bool analyzeClimateMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
   return !classificationNeeded;
 }
 
+std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+applyHighlighted(UIContext &uiContext) {
+  auto &climateUI = uiContext.climateUI;
+  std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> applied;
+  EditHistory::Edit edit(climateUI.climateInputMap.imageData);
+  for (auto &input : climateUI.climateInputColours.getMap()) {
+    if (climateUI.highlightedInputs.contains(input.second.in)) {
+      for (auto &pix : input.second.pixels) {
+        edit.set(pix, input.second.out);
+      }
+      applied.emplace_back(input.second.in, input.second.out);
+      climateUI.highlightedInputs.erase(input.second.in);
+    }
+  }
+  climateUI.inputHistory.push(std::move(edit), "apply all");
+  return applied;
+}
+
 bool complexTerrainMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                            UIContext &uiContext) {
   bool updated = false;
@@ -256,26 +285,27 @@ bool complexTerrainMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
   updated |= RenderScrollableClimateInput(
       uiContext.climateUI.climateInputMap.imageData, uiContext);
+  auto &climateUI = uiContext.climateUI;
+  updated |= climateUI.inputHistory.showControls(
+      climateUI.climateInputMap.imageData, climateUI.highlightedInputs,
+      [&climateUI](const Fwg::Gfx::Colour &colour) {
+        return climateUI.climateInputColours.contains(colour);
+      });
 
   // "Apply all" option
   if (!uiContext.climateUI.highlightedInputs.empty()) {
     ImGui::Text("Before next analysis, apply all types");
     if (ImGui::Button("Apply all")) {
-      for (auto &input : uiContext.climateUI.climateInputColours.getMap()) {
-        if (uiContext.climateUI.highlightedInputs.contains(input.second.in)) {
-          for (auto &pix : input.second.pixels) {
-            uiContext.climateUI.climateInputMap.setColourAtIndex(
-                pix, input.second.out);
-          }
-          uiContext.climateUI.highlightedInputs.erase(input.second.in);
-        }
-      }
+      uiContext.asyncContext.journal.recordClassification(
+          Drops::Target::CLIMATE_INPUT, applyHighlighted(uiContext));
       updated = true;
     }
   }
   // Re-analyze
   else if (ImGui::Button("Analyze Input") || uiContext.climateUI.analyze) {
     analyzeClimateMap(cfg, fwg, uiContext.climateUI.climateInputMap, uiContext);
+    uiContext.asyncContext.journal.recordAnalysis(
+        Drops::Target::CLIMATE_INPUT, false);
     uiContext.climateUI.analyze = false;
   }
 
@@ -283,11 +313,39 @@ bool complexTerrainMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                uiContext.climateUI.amountClassificationsNeeded);
   return updated;
 }
+
+void restoreInput(
+    Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg, const Fwg::Gfx::Image &image,
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+    UIContext &uiContext) {
+  auto &climateUI = uiContext.climateUI;
+  climateUI.climateInputMap = image;
+  climateUI.inputHistory.clear();
+  climateUI.highlightedInputs.clear();
+  analyzeClimateMap(cfg, fwg, climateUI.climateInputMap, uiContext);
+  setClassifications(mapping, uiContext);
+}
+
+void setClassifications(
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+    UIContext &uiContext) {
+  auto &climateUI = uiContext.climateUI;
+  for (const auto &[in, out] : mapping) {
+    if (climateUI.climateInputColours.contains(in)) {
+      climateUI.climateInputColours[in].out = out;
+      if (in != out) {
+        climateUI.highlightedInputs.insert(in);
+      }
+    }
+  }
+}
 } // namespace Input
 
 int showTemperatureMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                        UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Temperature")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Temperature",
+          uiContext.staleTab(Stages::StageId::TEMPERATURE, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::Climate::displayTemperature(fwg.climateData));
@@ -304,23 +362,30 @@ int showTemperatureMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     ImGui::Spacing();
 
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate Temperature Map",
                                             ImVec2(220, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genTemperatures(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::TEMPERATURE, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Temperature"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
       if (uiContext.triggeredDrag) {
-        fwg.loadTemperatures(cfg, uiContext.draggedFile, applyAltitudeEffect);
+        uiContext.asyncContext.loadDrop({Drops::Target::TEMPERATURE,
+                                         uiContext.draggedFile,
+                                         applyAltitudeEffect},
+                                        cfg, fwg);
+        uiContext.asyncContext.staleness.markLoaded(
+            Stages::StageId::TEMPERATURE);
         uiContext.triggeredDrag = false;
         uiContext.imageContext.resetTexture();
       }
@@ -333,7 +398,8 @@ int showTemperatureMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
 int showHumidityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                     UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Humidity")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Humidity", uiContext.staleTab(Stages::StageId::HUMIDITY, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::Climate::displayHumidity(fwg.climateData));
@@ -350,26 +416,29 @@ int showHumidityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     ImGui::Spacing();
 
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate Humidity Map",
                                             ImVec2(220, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genHumidity(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::HUMIDITY, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Humidity"));
               uiContext.imageContext.resetTexture(0);
-              return true;
+              return finished;
             });
       }
 
       if (uiContext.triggeredDrag) {
-        fwg.loadHumidity(
-            cfg, Fwg::IO::Reader::readGenericImage(uiContext.draggedFile, cfg),
-            applyElevationEffect);
-        uiContext.generationContext.redoHumidity = false;
+        uiContext.asyncContext.loadDrop({Drops::Target::HUMIDITY,
+                                         uiContext.draggedFile,
+                                         applyElevationEffect},
+                                        cfg, fwg);
+        uiContext.asyncContext.staleness.markLoaded(Stages::StageId::HUMIDITY);
         uiContext.triggeredDrag = false;
         uiContext.imageContext.resetTexture();
       }
@@ -382,7 +451,8 @@ int showHumidityTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
 int showRiverTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                  UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Rivers")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Rivers", uiContext.staleTab(Stages::StageId::RIVERS, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Gfx::riverMap(fwg.terrainData.detailedHeightMap,
@@ -396,30 +466,33 @@ int showRiverTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     {
       UI::Elements::GridLayout grid(2, 200.0f, 12.0f);
       grid.AddInputDouble("River Multiplier", &cfg.riverFactor, 0.0, 10.0);
-      grid.AddText("River Count", "%d", (int)fwg.climateData.rivers.size());
+      grid.AddText("River Count", "%d", uiContext.summary().riverCount);
     }
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData),
-         UI::PrerequisiteChecker::humidity(fwg.climateData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary()),
+         UI::PrerequisiteChecker::humidity(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate River Map",
                                             ImVec2(200, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genRivers(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::RIVERS, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Rivers"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
       if (uiContext.triggeredDrag) {
-        fwg.loadRivers(
-            cfg, Fwg::IO::Reader::readGenericImage(uiContext.draggedFile, cfg));
+        uiContext.asyncContext.loadDrop(
+            {Drops::Target::RIVERS, uiContext.draggedFile}, cfg, fwg);
+        uiContext.asyncContext.staleness.markLoaded(Stages::StageId::RIVERS);
         uiContext.imageContext.resetTexture();
         uiContext.triggeredDrag = false;
       }
@@ -431,7 +504,8 @@ int showRiverTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 }
 int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                    UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Climate")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Climate", uiContext.staleTab(Stages::StageId::CLIMATE, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::Climate::displayClimate(fwg.climateData, false));
@@ -442,11 +516,11 @@ int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     ImGui::SeparatorText("Generate climate map or drop it in");
 
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData),
-         UI::PrerequisiteChecker::humidity(fwg.climateData),
-         UI::PrerequisiteChecker::temperature(fwg.climateData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary()),
+         UI::PrerequisiteChecker::humidity(uiContext.summary()),
+         UI::PrerequisiteChecker::temperature(uiContext.summary())});
 
     if (guard.ready()) {
       if (!cfg.fantasyClimate &&
@@ -454,25 +528,30 @@ int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
               "Generate Climate Zones from Temperature and Heightmap Data")) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              if (uiContext.generationContext.redoHumidity) {
-                fwg.genTemperatures(cfg);
-                fwg.genHumidity(cfg);
-                uiContext.generationContext.redoHumidity = false;
-              }
-              fwg.genClimate(cfg);
+              // only redo the climate inputs whose parameters changed
+              auto stages = uiContext.asyncContext.staleness.staleStages(
+                  cfg, {Stages::get(Stages::StageId::TEMPERATURE),
+                        Stages::get(Stages::StageId::HUMIDITY),
+                        Stages::get(Stages::StageId::RIVERS)});
+              stages.push_back(Stages::get(Stages::StageId::CLIMATE));
+              const bool finished = Stages::runStages(
+                  stages, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Climate"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       } else if (cfg.fantasyClimate &&
                  ImGui::Button("Generate completely random fantasy climate")) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genTemperatures(cfg);
-              fwg.genHumidity(cfg);
-              uiContext.generationContext.redoHumidity = false;
-              fwg.genClimate(cfg);
+              const bool finished = Stages::runStages(
+                  {Stages::get(Stages::StageId::TEMPERATURE),
+                   Stages::get(Stages::StageId::HUMIDITY),
+                   Stages::get(Stages::StageId::CLIMATE)},
+                  cfg, fwg,
+                  uiContext.asyncContext.runOptions("Fantasy climate"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
@@ -480,8 +559,15 @@ int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         if (uiContext.climateUI.climateInputMap.initialised()) {
           uiContext.asyncContext.computationFutureBool =
               uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-                fwg.loadClimate(cfg, uiContext.climateUI.climateInputMap);
-                fwg.genWorldMap(cfg);
+                // the classified input is loaded instead of the file
+                uiContext.asyncContext.loadDrop(
+                    {Drops::Target::CLIMATE, uiContext.draggedFile, true}, cfg,
+                    fwg, uiContext.climateUI.climateInputMap);
+                uiContext.asyncContext.staleness.markLoaded(
+                    Stages::StageId::CLIMATE);
+                Stages::runStage(
+                    Stages::StageId::WORLDMAP, cfg, fwg,
+                    uiContext.asyncContext.runOptions("World map"));
                 uiContext.imageContext.resetTexture();
                 return true;
               });
@@ -491,7 +577,12 @@ int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
               Fwg::IO::Reader::readGenericImage(uiContext.draggedFile, cfg);
           // load a valid map if no classificationsNeeded
           if (Input::analyzeClimateMap(cfg, fwg, climateInput, uiContext)) {
+            // the analysis needs the window, a replay only loads the file
+            uiContext.asyncContext.journal.recordDrop(
+                {Drops::Target::CLIMATE, uiContext.draggedFile});
             fwg.loadClimate(cfg, climateInput);
+            uiContext.asyncContext.staleness.markLoaded(
+                Stages::StageId::CLIMATE);
             uiContext.imageContext.resetTexture();
           } else {
             Fwg::Utils::Logging::logLine(
@@ -516,7 +607,8 @@ int showClimateTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
 int showTreeTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                 UIContext &uiContext) {
-  if (UI::Elements::BeginSubTabItem("Forests")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Forests", uiContext.staleTab(Stages::StageId::FORESTS, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::Climate::displayClimate(fwg.climateData, true));
@@ -543,25 +635,29 @@ int showTreeTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData),
-         UI::PrerequisiteChecker::humidity(fwg.climateData),
-         UI::PrerequisiteChecker::temperature(fwg.climateData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary()),
+         UI::PrerequisiteChecker::humidity(uiContext.summary()),
+         UI::PrerequisiteChecker::temperature(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate Forest Map",
                                             ImVec2(200, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
-              fwg.genForests(cfg);
+              const bool finished = Stages::runStage(
+                  Stages::StageId::FORESTS, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Forests"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
       if (uiContext.triggeredDrag) {
-        fwg.loadForests(cfg, uiContext.draggedFile);
+        uiContext.asyncContext.loadDrop(
+            {Drops::Target::FORESTS, uiContext.draggedFile}, cfg, fwg);
+        uiContext.asyncContext.staleness.markLoaded(Stages::StageId::FORESTS);
         uiContext.triggeredDrag = false;
         uiContext.imageContext.resetTexture();
       }
@@ -0,0 +1,303 @@
+#include "UI/ColdLayers.h"
+#include "UI/MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+
+namespace Fwg::UI::Stages {
+using Value = LayerField::value_type;
+static_assert(std::is_trivially_copyable_v<Value>);
+
+static void packPlane(const std::vector<std::uint8_t> &plane,
+                      std::vector<std::uint8_t> &out) {
+  // a control byte below 128 is followed by that many plus one literals,
+  // from 128 on it repeats the next byte control - 125 times
+  std::size_t i = 0;
+  std::size_t literalStart = 0;
+  auto flushLiterals = [&](std::size_t end) {
+    while (literalStart < end) {
+      const auto count = std::min<std::size_t>(128, end - literalStart);
+      out.push_back(static_cast<std::uint8_t>(count - 1));
+      out.insert(out.end(), plane.begin() + literalStart,
+                 plane.begin() + literalStart + count);
+      literalStart += count;
+    }
+  };
+  while (i < plane.size()) {
+    std::size_t run = 1;
+    while (i + run < plane.size() && run < 130 &&
+           plane[i + run] == plane[i]) {
+      run++;
+    }
+    if (run >= 3) {
+      flushLiterals(i);
+      out.push_back(static_cast<std::uint8_t>(run + 125));
+      out.push_back(plane[i]);
+      i += run;
+      literalStart = i;
+    } else {
+      i += run;
+    }
+  }
+  flushLiterals(plane.size());
+}
+
+std::vector<std::uint8_t> pack(const std::uint8_t *data, std::size_t bytes,
+                               std::size_t elementSize) {
+  const auto count = bytes / elementSize;
+  std::vector<std::uint8_t> out;
+  std::vector<std::uint8_t> plane(count);
+  for (std::size_t p = 0; p < elementSize; p++) {
+    std::uint8_t previous = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      const auto value = data[i * elementSize + p];
+      plane[i] = value ^ previous;
+      previous = value;
+    }
+    packPlane(plane, out);
+  }
+  out.shrink_to_fit();
+  return out;
+}
+
+bool unpack(const std::vector<std::uint8_t> &packed, std::uint8_t *data,
+            std::size_t bytes, std::size_t elementSize) {
+  const auto count = bytes / elementSize;
+  std::vector<std::uint8_t> plane(count);
+  std::size_t in = 0;
+  for (std::size_t p = 0; p < elementSize; p++) {
+    std::size_t filled = 0;
+    while (filled < count) {
+      if (in >= packed.size()) {
+        return false;
+      }
+      const auto control = packed[in++];
+      if (control < 128) {
+        const std::size_t literals = control + 1u;
+        if (in + literals > packed.size() || filled + literals > count) {
+          return false;
+        }
+        std::memcpy(plane.data() + filled, packed.data() + in, literals);
+        in += literals;
+        filled += literals;
+      } else {
+        const std::size_t run = control - 125u;
+        if (in >= packed.size() || filled + run > count) {
+          return false;
+        }
+        std::memset(plane.data() + filled, packed[in++], run);
+        filled += run;
+      }
+    }
+    std::uint8_t previous = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      previous ^= plane[i];
+      data[i * elementSize + p] = previous;
+    }
+  }
+  return in == packed.size();
+}
+
+// copies a range of the scratch file through a read only mapping
+static bool readMapped(const std::string &path, std::size_t offset,
+                       std::size_t bytes, void *destination) {
+  if (!bytes) {
+    return true;
+  }
+  MappedFile file;
+  if (!file.open(path) || file.size() < offset + bytes) {
+    return false;
+  }
+  std::memcpy(destination, file.data() + offset, bytes);
+  return true;
+}
+
+static auto *layerGroup(Fwg::FastWorldGenerator &fwg, int group) {
+  auto &terrain = fwg.terrainData;
+  return group == 0   ? &terrain.shapeLayers
+         : group == 1 ? &terrain.landLayers
+                      : &terrain.seaLayers;
+}
+
+ColdLayers::Stash::~Stash() {
+  if (!file.empty()) {
+    std::error_code error;
+    std::filesystem::remove(file, error);
+  }
+}
+
+ColdLayers &ColdLayers::shared() {
+  static ColdLayers layers;
+  return layers;
+}
+
+void ColdLayers::setScratchFolder(const std::string &folder) {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::error_code error;
+  std::filesystem::create_directories(folder, error);
+  scratchFolder = folder;
+}
+
+void ColdLayers::freeze(Fwg::FastWorldGenerator &fwg) {
+  const auto leanMode = mode.load();
+  if (leanMode == LeanMode::OFF) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  auto next = std::make_shared<Stash>();
+  std::ofstream spill;
+  if (leanMode == LeanMode::SPILL) {
+    // a file per stash, a backup may still share the previous one
+    next->file =
+        scratchFolder + "coldLayers" + std::to_string(spills++) + ".bin";
+    spill.open(next->file, std::ios::binary | std::ios::trunc);
+    if (!spill.good()) {
+      Fwg::Utils::Logging::logLine("ERROR: Couldn't open scratch file ",
+                                   next->file, ", keeping layers in memory");
+      return;
+    }
+  }
+  for (int group = 0; group < 3; group++) {
+    for (const auto &layer : *layerGroup(fwg, group)) {
+      const auto bytes = layer.size() * sizeof(Value);
+      const auto *data = reinterpret_cast<const std::uint8_t *>(layer.data());
+      next->lengths[group].push_back(layer.size());
+      next->rawBytes += bytes;
+      if (leanMode == LeanMode::COMPRESS) {
+        next->packed.push_back(pack(data, bytes, sizeof(Value)));
+        next->heldBytes += next->packed.back().size();
+      } else {
+        spill.write(reinterpret_cast<const char *>(data), bytes);
+      }
+    }
+  }
+  if (!next->rawBytes) {
+    return;
+  }
+  if (spill.is_open() && !spill.good()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write scratch file ",
+                                 next->file, ", keeping layers in memory");
+    return;
+  }
+  for (int group = 0; group < 3; group++) {
+    auto &layers = *layerGroup(fwg, group);
+    layers.clear();
+    layers.shrink_to_fit();
+  }
+  stash = std::move(next);
+  Fwg::Utils::Logging::logLine("Lean memory: froze ", stash->rawBytes >> 20,
+                               "MB of layers into ", stash->heldBytes >> 20,
+                               "MB");
+}
+
+bool ColdLayers::thaw(Fwg::FastWorldGenerator &fwg) {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto held = std::move(stash);
+  // a restored backup or cache entry brought its own layers
+  for (int group = 0; group < 3; group++) {
+    if (!layerGroup(fwg, group)->empty()) {
+      return true;
+    }
+  }
+  if (!held) {
+    return !layered;
+  }
+  bool restoredAll = true;
+  std::size_t index = 0;
+  std::size_t offset = 0;
+  for (int group = 0; group < 3; group++) {
+    auto &layers = *layerGroup(fwg, group);
+    for (const auto length : held->lengths[group]) {
+      LayerField field(length);
+      const auto bytes = length * sizeof(Value);
+      auto *data = reinterpret_cast<std::uint8_t *>(field.data());
+      const bool restored =
+          held->packed.empty()
+              ? readMapped(held->file, offset, bytes, data)
+              : unpack(held->packed[index], data, bytes, sizeof(Value));
+      if (!restored) {
+        Fwg::Utils::Logging::logLine("ERROR: Couldn't restore frozen layer ",
+                                     index);
+        restoredAll = false;
+      }
+      layers.push_back(std::move(field));
+      index++;
+      offset += bytes;
+    }
+  }
+  if (!restoredAll) {
+    // partly zeroed layers would make a wrong land map
+    for (int group = 0; group < 3; group++) {
+      layerGroup(fwg, group)->clear();
+    }
+  }
+  return restoredAll;
+}
+
+void ColdLayers::discard(bool layered) {
+  std::lock_guard<std::mutex> lock(mutex);
+  stash = nullptr;
+  this->layered = layered;
+}
+
+ColdLayers::State ColdLayers::state() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return {stash, layered};
+}
+
+void ColdLayers::restore(State state) {
+  std::lock_guard<std::mutex> lock(mutex);
+  stash = std::move(state.stash);
+  layered = state.layered;
+}
+
+bool ColdLayers::frozen() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stash != nullptr;
+}
+
+bool ColdLayers::peek(int group, std::size_t index, LayerField &field) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!stash || group < 0 || group > 2 ||
+      index >= stash->lengths[group].size()) {
+    return false;
+  }
+  std::size_t position = 0;
+  std::size_t offset = 0;
+  for (int previous = 0; previous < group; previous++) {
+    for (const auto length : stash->lengths[previous]) {
+      position++;
+      offset += length * sizeof(Value);
+    }
+  }
+  for (std::size_t i = 0; i < index; i++) {
+    offset += stash->lengths[group][i] * sizeof(Value);
+  }
+  position += index;
+  field.resize(stash->lengths[group][index]);
+  const auto bytes = field.size() * sizeof(Value);
+  auto *data = reinterpret_cast<std::uint8_t *>(field.data());
+  return stash->packed.empty()
+             ? readMapped(stash->file, offset, bytes, data)
+             : unpack(stash->packed[position], data, bytes, sizeof(Value));
+}
+
+std::size_t ColdLayers::heldLayers(int group) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stash && group >= 0 && group <= 2 ? stash->lengths[group].size()
+                                           : 0;
+}
+
+std::size_t ColdLayers::savedBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stash ? stash->rawBytes - stash->heldBytes : 0;
+}
+
+std::size_t ColdLayers::heldBytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return stash ? stash->heldBytes : 0;
+}
+
+} // namespace Fwg::UI::Stages
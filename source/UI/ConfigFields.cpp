@@ -0,0 +1,395 @@
+#include "UI/ConfigFields.h"
+#include <functional>
+#include <limits>
+#include <sstream>
+#include <type_traits>
+
+namespace Fwg::UI::ConfigFields {
+
+template <typename T> static std::string text(const T &value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    return value ? "true" : "false";
+  } else if constexpr (std::is_enum_v<T>) {
+    return std::to_string(static_cast<int>(value));
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return value;
+  } else {
+    std::ostringstream stream;
+    stream.precision(std::numeric_limits<T>::max_digits10);
+    stream << value;
+    return stream.str();
+  }
+}
+
+template <typename T> static bool parse(const std::string &text, T &value) {
+  if constexpr (std::is_same_v<T, bool>) {
+    if (text != "true" && text != "false") {
+      return false;
+    }
+    value = text == "true";
+    return true;
+  } else if constexpr (std::is_enum_v<T>) {
+    int number = 0;
+    if (!parse(text, number)) {
+      return false;
+    }
+    value = static_cast<T>(number);
+    return true;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    value = text;
+    return true;
+  } else {
+    std::istringstream stream(text);
+    T parsed{};
+    if (!(stream >> parsed) || !(stream >> std::ws).eof()) {
+      return false;
+    }
+    value = parsed;
+    return true;
+  }
+}
+
+template <typename Owner> struct Field {
+  const char *name;
+  std::function<std::string(const Owner &)> get;
+  std::function<bool(Owner &, const std::string &)> set;
+};
+
+template <typename Owner, auto member>
+static Field<Owner> field(const char *name) {
+  return {name, [](const Owner &owner) { return text(owner.*member); },
+          [](Owner &owner, const std::string &value) {
+            return parse(value, owner.*member);
+          }};
+}
+
+static const std::vector<Field<Fwg::Cfg>> &fields() {
+  using C = Fwg::Cfg;
+  static const std::vector<Field<C>> fields{
+      field<C, &C::debugLevel>("module.debugLevel"),
+      field<C, &C::mapSeed>(seedPath),
+      field<C, &C::heightAdjustments>("loadMaps.heightAdjustments"),
+      field<C, &C::width>("map.width"),
+      field<C, &C::height>("map.height"),
+      field<C, &C::landPercentage>("map.landPercentage"),
+      field<C, &C::seaLevel>("map.seaLevel"),
+      field<C, &C::sobelFactor>("map.sobelFactor"),
+      field<C, &C::fantasyClimate>("map.climate.fantasyClimate"),
+      field<C, &C::fantasyClimateFrequency>(
+          "map.climate.fantasyClimateFrequency"),
+      field<C, &C::riverFactor>("map.rivers.riverFactor"),
+      field<C, &C::latLow>("map.humidity.latitudeLow"),
+      field<C, &C::latHigh>("map.humidity.latitudeHigh"),
+      field<C, &C::riverHumidityFactor>("map.humidity.riverHumidityFactor"),
+      field<C, &C::riverEffectRangeFactor>(
+          "map.humidity.riverEffectRangeFactor"),
+      field<C, &C::baseHumidity>("map.humidity.baseHumidity"),
+      field<C, &C::baseTemperature>("map.humidity.baseTemperature"),
+      field<C, &C::borealDensity>("map.trees.borealDensity"),
+      field<C, &C::temperateNeedleDensity>("map.trees.temperateNeedleDensity"),
+      field<C, &C::temperateMixedDensity>("map.trees.temperateMixedDensity"),
+      field<C, &C::sparseDensity>("map.trees.sparseDensity"),
+      field<C, &C::tropicalDryDensity>("map.trees.tropicalDryDensity"),
+      field<C, &C::tropicalMoistDensity>("map.trees.tropicalMoistDensity"),
+      field<C, &C::landProvFactor>("map.areas.provinces.landProvinceFactor"),
+      field<C, &C::seaProvFactor>("map.areas.provinces.seaProvinceFactor"),
+      field<C, &C::minProvSize>("map.areas.provinces.minProvSize"),
+      field<C, &C::provinceDensityEffects>(
+          "map.areas.provinces.provinceDensityEffects"),
+      field<C, &C::maxProvAmount>("map.areas.provinces.maxProvAmount"),
+      field<C, &C::autoLandRegionParams>("map.areas.regions.autoLandRegions"),
+      field<C, &C::autoSeaRegionParams>("map.areas.regions.autoSeaRegions"),
+      field<C, &C::targetLandRegionAmount>(
+          "map.areas.regions.targetLandRegionAmount"),
+      field<C, &C::targetSeaRegionAmount>(
+          "map.areas.regions.targetSeaRegionAmount"),
+      field<C, &C::segmentCostInfluence>(
+          "map.areas.segments.segmentCostInfluence"),
+      field<C, &C::segmentDistanceInfluence>(
+          "map.areas.segments.segmentDistanceInfluence"),
+      field<C, &C::maxAmountOfContinents>(
+          "map.areas.continents.maxAmountOfContinents"),
+      field<C, &C::heightmapFrequencyModifier>(
+          "map.heightmap.heightmapFrequencyModifier"),
+      field<C, &C::layerApplicationFactor>(
+          "map.heightmap.layerApplicationFactor"),
+      field<C, &C::maxLandHeight>("map.heightmap.maxLandHeight"),
+      field<C, &C::lakeMaxShare>("map.heightmap.lakeMaxShare"),
+      field<C, &C::globalEdgeFadeWidthModifier>(
+          "map.heightmap.globalEdgeFadeWidthModifier"),
+      field<C, &C::globalEdgeFadeHeightModifier>(
+          "map.heightmap.globalEdgeFadeHeightModifier"),
+      field<C, &C::landInputMode>("input.landInputMode"),
+      field<C, &C::areaInputMode>("input.areaInputMode"),
+      field<C, &C::complexClimateInput>("input.complexClimateInput")};
+  return fields;
+}
+
+static const std::vector<Field<LayerConfig>> &layerFields() {
+  using L = LayerConfig;
+  static const std::vector<Field<L>> fields{
+      field<L, &L::type>("type"),
+      field<L, &L::noiseType>("noiseType"),
+      field<L, &L::fractalType>("fractalType"),
+      field<L, &L::fractalFrequency>("fractalFrequency"),
+      field<L, &L::fractalOctaves>("fractalOctaves"),
+      field<L, &L::fractalGain>("fractalGain"),
+      field<L, &L::seed>("seed"),
+      field<L, &L::weight>("weight"),
+      field<L, &L::minHeight>("minHeight"),
+      field<L, &L::maxHeight>("maxHeight"),
+      field<L, &L::tanFactor>("tanFactor"),
+      field<L, &L::edgeFadeWidth>("edgeFadeWidth"),
+      field<L, &L::edgeFadeHeight>("edgeFadeHeight"),
+      field<L, &L::altitudeWeightStart>("altitudeWeightStart"),
+      field<L, &L::altitudeWeightEnd>("altitudeWeightEnd")};
+  return fields;
+}
+
+static const std::vector<Field<Fwg::Terrain::HeightmapOperation>> &
+operationFields() {
+  using O = Fwg::Terrain::HeightmapOperation;
+  static const std::vector<Field<O>> fields{field<O, &O::type>("type"),
+                                            field<O, &O::enabled>("enabled"),
+                                            field<O, &O::name>("name")};
+  return fields;
+}
+
+static const std::vector<Field<Fwg::Terrain::LandformDefinition>> &
+landformFields() {
+  using D = Fwg::Terrain::LandformDefinition;
+  static const std::vector<Field<D>> fields{
+      field<D, &D::landformFactor>("landformFactor")};
+  return fields;
+}
+
+static const std::pair<const char *, std::vector<LayerConfig> Fwg::Cfg::*>
+    layerGroups[] = {{"shapeLayers", &Fwg::Cfg::shapeLayers},
+                     {"landLayers", &Fwg::Cfg::landLayers},
+                     {"seaLayers", &Fwg::Cfg::seaLayers}};
+
+const std::vector<OperationParameter> &
+operationParameters(Fwg::Terrain::HeightmapOperationType type) {
+  using Fwg::Terrain::HeightmapOperationType;
+  using Kind = OperationParameter::Kind;
+  static const std::map<HeightmapOperationType,
+                        std::vector<OperationParameter>>
+      parameters{
+          {HeightmapOperationType::APPLY_BASE_ALTITUDE,
+           {{"baseAltitudeEffects", Kind::FLOAT, 0.5f},
+            {"blurFactor", Kind::FLOAT, 1.0f}}},
+          {HeightmapOperationType::APPLY_LAND_LAYERS,
+           {{"useWeights", Kind::BOOL, 1.0f}}},
+          {HeightmapOperationType::RANDOMIZE_WEIGHTS,
+           {{"randomisationFactor", Kind::FLOAT, 0.5f}}},
+          {HeightmapOperationType::GAUSSIAN_BLUR_WEIGHTS,
+           {{"radius", Kind::FLOAT, 2.0f}, {"sigma", Kind::FLOAT, 1.0f}}},
+          {HeightmapOperationType::GAUSSIAN_BLUR,
+           {{"radius", Kind::FLOAT, 2.0f}, {"sigma", Kind::FLOAT, 1.0f}}},
+          {HeightmapOperationType::GULLY_EROSION,
+           {{"iterations", Kind::INT, 1.0f},
+            {"intensity", Kind::FLOAT, 0.5f}}},
+          {HeightmapOperationType::NORMALIZE,
+           {{"min", Kind::FLOAT, 0.0f}, {"max", Kind::FLOAT, 255.0f}}},
+          {HeightmapOperationType::CLAMP_VALUES,
+           {{"min", Kind::FLOAT, 0.0f}, {"max", Kind::FLOAT, 255.0f}}},
+          {HeightmapOperationType::CRATER_GENERATION,
+           {{"count", Kind::INT, 50.0f},
+            {"minRadius", Kind::FLOAT, 5.0f},
+            {"maxRadius", Kind::FLOAT, 30.0f},
+            {"depthFactor", Kind::FLOAT, 0.5f},
+            {"rimFactor", Kind::FLOAT, 0.3f},
+            {"seed", Kind::INT, 0.0f}}},
+          {HeightmapOperationType::TERRACE_HEIGHTS,
+           {{"steps", Kind::INT, 5.0f},
+            {"smoothing", Kind::FLOAT, 0.5f},
+            {"respectMask", Kind::BOOL, 1.0f}}},
+          {HeightmapOperationType::RIDGE_GENERATION,
+           {{"strength", Kind::FLOAT, 20.0f},
+            {"frequency", Kind::FLOAT, 2.0f},
+            {"sharpness", Kind::FLOAT, 3.0f},
+            {"seed", Kind::INT, 0.0f}}}};
+  static const std::vector<OperationParameter> none;
+  const auto entry = parameters.find(type);
+  return entry == parameters.end() ? none : entry->second;
+}
+
+// getParameter works on mutable operations, so op is a copy
+static std::string parameterText(Fwg::Terrain::HeightmapOperation op,
+                                 const OperationParameter &parameter) {
+  using Kind = OperationParameter::Kind;
+  switch (parameter.kind) {
+  case Kind::INT:
+    return text(Fwg::Terrain::getParameter<int>(
+        op, parameter.name, static_cast<int>(parameter.fallback)));
+  case Kind::BOOL:
+    return text(Fwg::Terrain::getParameter<bool>(op, parameter.name,
+                                                 parameter.fallback != 0.0f));
+  default:
+    return text(Fwg::Terrain::getParameter<float>(op, parameter.name,
+                                                  parameter.fallback));
+  }
+}
+
+template <typename T>
+static bool setParameter(Fwg::Terrain::HeightmapOperation &op,
+                         const char *name, const std::string &value) {
+  T parsed{};
+  if (!parse(value, parsed)) {
+    return false;
+  }
+  Fwg::Terrain::setParameter(op, name, parsed);
+  return true;
+}
+
+static bool setParameter(Fwg::Terrain::HeightmapOperation &op,
+                         const std::string &name, const std::string &value) {
+  using Kind = OperationParameter::Kind;
+  for (const auto &parameter : operationParameters(op.type)) {
+    if (name != parameter.name) {
+      continue;
+    }
+    switch (parameter.kind) {
+    case Kind::INT:
+      return setParameter<int>(op, parameter.name, value);
+    case Kind::BOOL:
+      return setParameter<bool>(op, parameter.name, value);
+    default:
+      return setParameter<float>(op, parameter.name, value);
+    }
+  }
+  return false;
+}
+
+// sets the named field of one of the elements of a list, the amount entry
+// resizes the list
+template <typename Element>
+static bool setElement(std::vector<Element> &list,
+                       const std::vector<Field<Element>> &elementFields,
+                       const std::string &rest, const std::string &value,
+                       bool resizable) {
+  const auto separator = rest.find('.');
+  if (separator == std::string::npos) {
+    int amount = 0;
+    if (rest != "amount" || !resizable || !parse(value, amount) ||
+        amount < 0) {
+      return false;
+    }
+    list.resize(amount);
+    return true;
+  }
+  int index = 0;
+  if (!parse(rest.substr(0, separator), index) || index < 0) {
+    return false;
+  }
+  if (index >= static_cast<int>(list.size())) {
+    if (!resizable) {
+      return false;
+    }
+    list.resize(index + 1);
+  }
+  const auto name = rest.substr(separator + 1);
+  for (const auto &field : elementFields) {
+    if (name == field.name) {
+      return field.set(list[index], value);
+    }
+  }
+  if constexpr (std::is_same_v<Element, Fwg::Terrain::HeightmapOperation>) {
+    return setParameter(list[index], name, value);
+  }
+  return false;
+}
+
+std::map<std::string, std::string> flatten(const Fwg::Cfg &cfg) {
+  std::map<std::string, std::string> values;
+  for (const auto &field : fields()) {
+    values[field.name] = field.get(cfg);
+  }
+  for (const auto &[group, member] : layerGroups) {
+    const auto &layers = cfg.*member;
+    const std::string prefix = std::string("map.heightmap.") + group + ".";
+    values[prefix + "amount"] = text(layers.size());
+    for (std::size_t i = 0; i < layers.size(); i++) {
+      for (const auto &field : layerFields()) {
+        values[prefix + std::to_string(i) + "." + field.name] =
+            field.get(layers[i]);
+      }
+    }
+  }
+  const auto &operations = cfg.terrainConfig.heightmapPipeline.operations;
+  values["map.heightmap.pipeline.amount"] = text(operations.size());
+  for (std::size_t i = 0; i < operations.size(); i++) {
+    const auto prefix = "map.heightmap.pipeline." + std::to_string(i) + ".";
+    for (const auto &field : operationFields()) {
+      values[prefix + field.name] = field.get(operations[i]);
+    }
+    for (const auto &parameter : operationParameters(operations[i].type)) {
+      values[prefix + parameter.name] = parameterText(operations[i], parameter);
+    }
+  }
+  const auto &landforms = cfg.terrainConfig.landformDefinitions;
+  for (std::size_t i = 0; i < landforms.size(); i++) {
+    values["map.landforms." + std::to_string(i) + ".landformFactor"] =
+        text(landforms[i].landformFactor);
+  }
+  return values;
+}
+
+bool set(Fwg::Cfg &cfg, const std::string &path, const std::string &value) {
+  for (const auto &field : fields()) {
+    if (path == field.name) {
+      return field.set(cfg, value);
+    }
+  }
+  for (const auto &[group, member] : layerGroups) {
+    const std::string prefix = std::string("map.heightmap.") + group + ".";
+    if (path.starts_with(prefix)) {
+      return setElement(cfg.*member, layerFields(),
+                        path.substr(prefix.size()), value, true);
+    }
+  }
+  const std::string pipeline = "map.heightmap.pipeline.";
+  if (path.starts_with(pipeline)) {
+    return setElement(cfg.terrainConfig.heightmapPipeline.operations,
+                      operationFields(), path.substr(pipeline.size()), value,
+                      true);
+  }
+  // the landforms are fixed, only their factors can be edited
+  const std::string landforms = "map.landforms.";
+  if (path.starts_with(landforms)) {
+    return setElement(cfg.terrainConfig.landformDefinitions, landformFields(),
+                      path.substr(landforms.size()), value, false);
+  }
+  return false;
+}
+
+boost::property_tree::ptree tree(const Fwg::Cfg &cfg) {
+  boost::property_tree::ptree root;
+  for (const auto &[path, value] : flatten(cfg)) {
+    root.put(path, value);
+  }
+  return root;
+}
+
+static bool applyNode(const boost::property_tree::ptree &node,
+                      const std::string &path, Fwg::Cfg &cfg) {
+  if (node.empty()) {
+    if (set(cfg, path, node.data())) {
+      return true;
+    }
+    Fwg::Utils::Logging::logLine("ERROR: Invalid config field ", path, "=",
+                                 node.data());
+    return false;
+  }
+  bool valid = true;
+  for (const auto &[name, child] : node) {
+    valid &= applyNode(child, path.empty() ? name : path + "." + name, cfg);
+  }
+  return valid;
+}
+
+bool apply(const boost::property_tree::ptree &tree, Fwg::Cfg &cfg) {
+  return applyNode(tree, "", cfg);
+}
+
+} // namespace Fwg::UI::ConfigFields
@@ -4,7 +4,8 @@ namespace Fwg::UI::Drawing {
 
 void imageClick(ImGuiIO &io, UIContext &context) {
   // ensure we have an image to click on
-  if (!context.imageContext.activeImages[0].size()) {
+  const auto &activeImage = context.imageContext.activeImage(0);
+  if (!activeImage.size()) {
     return;
   }
   // Check if the mouse is clicked on the image
@@ -23,10 +24,10 @@ void imageClick(ImGuiIO &io, UIContext &context) {
 
     // Calculate the pixel position in the texture
     int pixelX = static_cast<int>((mousePosRelative.x / itemSize.x) *
-                                  context.imageContext.activeImages[0].width());
-    int pixelY = context.imageContext.activeImages[0].height() -
+                                  activeImage.width());
+    int pixelY = activeImage.height() -
                  static_cast<int>((mousePosRelative.y / itemSize.y) *
-                         context.imageContext.activeImages[0].height());
+                                  activeImage.height());
 
     // Determine the type of interaction based on the mouse button pressed and
     // whether the Ctrl key is held down
@@ -36,7 +37,7 @@ void imageClick(ImGuiIO &io, UIContext &context) {
 
     // Calculate the index of the pixel in the texture data
     int pixelIndex =
-        (pixelY * context.imageContext.activeImages[0].width() + pixelX);
+        (pixelY * activeImage.width() + pixelX);
 
     // If click events are being processed, add this event to the queue
     if (context.drawContext.processClickEvents) {
@@ -0,0 +1,143 @@
+#include "UI/Drops.h"
+#include "UI/UIUtils.h"
+
+namespace Fwg::UI::Drops {
+
+// reads an area map, in border mode the areas are coloured from the borders
+static Fwg::Gfx::Image readAreas(const std::string &path, Fwg::Cfg &cfg,
+                                 Fwg::FastWorldGenerator &fwg) {
+  const auto evaluationAreas =
+      Utils::Masks::getLandmaskEvaluationAreas(fwg.terrainData.landMask);
+  if (cfg.areaInputMode == Fwg::Areas::AreaInputType::SOLID) {
+    return Fwg::IO::Reader::readGenericImageWithBorders(path, cfg,
+                                                        evaluationAreas);
+  }
+  auto image = Fwg::IO::Reader::readGenericImage(path, cfg);
+  Fwg::Gfx::Filter::colouriseAreaBorderInputByBordersOnly(image,
+                                                          evaluationAreas);
+  Fwg::Gfx::Filter::fillBlackPixelsByArea(image, evaluationAreas);
+  return image;
+}
+
+// converts the secondary colours of the climate classes to their primary ones
+static bool readClimateInput(const std::string &path, Fwg::Cfg &cfg,
+                             Fwg::FastWorldGenerator &fwg,
+                             Fwg::Gfx::Image &input) {
+  input = Fwg::IO::Reader::readGenericImage(path, cfg);
+  Fwg::Utils::ColourTMap<Fwg::Climate::ClimateClassDefinition>
+      secondaryToPrimary;
+  for (auto &type : fwg.climateData.climateClassDefinitions) {
+    for (auto &secondary : type.secondaryColours) {
+      secondaryToPrimary.setValue(secondary, type);
+    }
+  }
+  for (auto &colour : input.imageData) {
+    if (secondaryToPrimary.contains(colour)) {
+      colour = secondaryToPrimary[colour].primaryColour;
+    }
+  }
+  if (input.size() != fwg.terrainData.detailedHeightMap.size()) {
+    Fwg::Utils::Logging::logLine(
+        "Climate input map size does not match height map size. Please "
+        "ensure that the input map is the same size as the height map");
+    input.clear();
+    return false;
+  }
+  return true;
+}
+
+bool load(const Drop &drop, Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+          Fwg::Gfx::Image &input) {
+  const auto &path = drop.path;
+  switch (drop.target) {
+  case Target::LAND_INPUT:
+    fwg.resetData();
+    fwg.configure(cfg);
+    // the colours are classified before anything is generated from landforms
+    input = Fwg::IO::Reader::readGenericImage(path, cfg, false);
+    if (cfg.landInputMode == Fwg::Terrain::InputMode::HEIGHTMAP) {
+      cfg.allowHeightmapModification = false;
+      fwg.loadHeight(cfg, Fwg::IO::Reader::readHeightmapImage(path, cfg));
+    } else if (cfg.landInputMode == Fwg::Terrain::InputMode::LANDMASK ||
+               cfg.landInputMode == Fwg::Terrain::InputMode::LANDFORM) {
+      fwg.genHeightFromInput(cfg, path, cfg.landInputMode);
+    }
+    return input.initialised();
+  case Target::HEIGHTMAP:
+    fwg.loadHeight(cfg, Fwg::IO::Reader::readHeightmapImage(path, cfg));
+    return true;
+  case Target::CLIMATE_INPUT:
+    return readClimateInput(path, cfg, fwg, input);
+  case Target::TEMPERATURE:
+    fwg.loadTemperatures(cfg, path, drop.option);
+    return true;
+  case Target::HUMIDITY:
+    fwg.loadHumidity(cfg, Fwg::IO::Reader::readGenericImage(path, cfg),
+                     drop.option);
+    return true;
+  case Target::RIVERS:
+    fwg.loadRivers(cfg, Fwg::IO::Reader::readGenericImage(path, cfg));
+    return true;
+  case Target::CLIMATE:
+    if (!drop.option) {
+      input = Fwg::IO::Reader::readGenericImage(path, cfg);
+    }
+    if (!input.initialised()) {
+      return false;
+    }
+    fwg.loadClimate(cfg, input);
+    return true;
+  case Target::FORESTS:
+    fwg.loadForests(cfg, path);
+    return true;
+  case Target::HABITABILITY:
+    fwg.loadHabitability(cfg, Fwg::IO::Reader::readGenericImage(path, cfg));
+    return true;
+  case Target::SUPERSEGMENTS:
+    fwg.loadSuperSegments(cfg, readAreas(path, cfg, fwg));
+    return true;
+  case Target::SEGMENTS:
+    fwg.loadSegments(cfg, readAreas(path, cfg, fwg));
+    return true;
+  case Target::PROVINCES:
+    fwg.loadProvinces(cfg, readAreas(path, cfg, fwg));
+    return true;
+  case Target::CONTINENTS:
+    fwg.loadContinents(
+        cfg, Fwg::IO::Reader::readGenericImageWithBorders(
+                 path, cfg,
+                 Utils::Masks::getLandmaskEvaluationAreas(
+                     fwg.terrainData.landMask)));
+    return true;
+  }
+  return false;
+}
+
+std::string text(const Drop &drop) {
+  return std::to_string(static_cast<int>(drop.target)) + ";" +
+         (drop.option ? "1" : "0") + ";" + drop.path;
+}
+
+bool parse(const std::string &text, Drop &drop) {
+  // the path may contain the separator
+  const auto first = text.find(';');
+  const auto second = text.find(';', first + 1);
+  if (first == std::string::npos || second == std::string::npos) {
+    return false;
+  }
+  int target = -1;
+  try {
+    target = std::stoi(text.substr(0, first));
+  } catch (const std::exception &) {
+    return false;
+  }
+  if (target < 0 || target > static_cast<int>(Target::CONTINENTS)) {
+    return false;
+  }
+  drop.target = static_cast<Target>(target);
+  drop.option = text.substr(first + 1, second - first - 1) == "1";
+  drop.path = text.substr(second + 1);
+  return true;
+}
+
+} // namespace Fwg::UI::Drops
@@ -0,0 +1,219 @@
+#include "UI/EditHistory.h"
+#include "imgui.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace Fwg::UI {
+
+std::uint32_t EditHistory::Edit::paletteId(const Fwg::Gfx::Colour &colour) {
+  // applies alternate between few colours, check the newest ones first
+  for (std::size_t i = palette.size(); i > 0 && i + 2 > palette.size(); i--) {
+    if (palette[i - 1] == colour) {
+      return static_cast<std::uint32_t>(i - 1);
+    }
+  }
+  const auto [entry, added] = paletteIds.try_emplace(
+      colour, static_cast<std::uint32_t>(palette.size()));
+  if (added) {
+    palette.push_back(colour);
+  }
+  return entry->second;
+}
+
+void EditHistory::Edit::set(int index, const Fwg::Gfx::Colour &colour) {
+  auto &pixel = pixels[index];
+  if (pixel == colour) {
+    return;
+  }
+  const auto before = paletteId(pixel);
+  const auto after = paletteId(colour);
+  pixel = colour;
+  const auto start = static_cast<std::uint32_t>(index);
+  if (!spans.empty()) {
+    auto &last = spans.back();
+    if (last.start + last.length == start && last.before == before &&
+        last.after == after) {
+      last.length++;
+      return;
+    }
+  }
+  spans.push_back({start, 1, before, after});
+}
+
+std::size_t EditHistory::Delta::bytes() const {
+  return name.capacity() + palette.capacity() * sizeof(Fwg::Gfx::Colour) +
+         spans.capacity() * sizeof(Span) + swaps.capacity() * sizeof(Swap);
+}
+
+EditHistory::Changes EditHistory::Delta::changes() const {
+  std::set<std::pair<std::uint32_t, std::uint32_t>> pairs;
+  for (const auto &span : spans) {
+    pairs.insert({span.before, span.after});
+  }
+  for (const auto &swap : swaps) {
+    pairs.insert({swap.before, swap.after});
+  }
+  Changes colours;
+  for (const auto &[before, after] : pairs) {
+    colours.emplace_back(palette[before], palette[after]);
+  }
+  return colours;
+}
+
+void EditHistory::compact(Delta &delta,
+                          const std::vector<Fwg::Gfx::Colour> &pixels) {
+  if (delta.spans.size() < swapThreshold) {
+    return;
+  }
+  std::map<std::pair<std::uint32_t, std::uint32_t>, std::size_t> written;
+  std::map<std::uint32_t, int> sources;
+  for (const auto &span : delta.spans) {
+    const auto [entry, added] =
+        written.try_emplace({span.before, span.after}, 0);
+    entry->second += span.length;
+    sources[span.before] += added ? 1 : 0;
+  }
+  // colour counts after the apply
+  std::unordered_map<Fwg::Gfx::Colour, std::size_t> counts;
+  for (const auto &[pair, count] : written) {
+    counts[delta.palette[pair.first]] = 0;
+    counts[delta.palette[pair.second]] = 0;
+  }
+  for (const auto &pixel : pixels) {
+    const auto entry = counts.find(pixel);
+    if (entry != counts.end()) {
+      entry->second++;
+    }
+  }
+  // a swap is exact if the apply wrote every pixel of the old colour, nothing
+  // else wrote that colour and no other pixel has the new one
+  std::set<std::pair<std::uint32_t, std::uint32_t>> swapped;
+  for (const auto &[pair, count] : written) {
+    if (sources[pair.first] == 1 && !counts[delta.palette[pair.first]] &&
+        counts[delta.palette[pair.second]] == count) {
+      delta.swaps.push_back({pair.first, pair.second});
+      swapped.insert(pair);
+    }
+  }
+  if (swapped.empty()) {
+    return;
+  }
+  std::erase_if(delta.spans, [&swapped](const Span &span) {
+    return swapped.contains({span.before, span.after});
+  });
+  delta.spans.shrink_to_fit();
+  delta.swaps.shrink_to_fit();
+}
+
+void EditHistory::patch(const Delta &delta,
+                        std::vector<Fwg::Gfx::Colour> &pixels, bool forward) {
+  // swaps first, spans may write pixels of a swapped colour in both
+  // directions
+  for (const auto &swap : delta.swaps) {
+    const auto &from = delta.palette[forward ? swap.before : swap.after];
+    const auto &to = delta.palette[forward ? swap.after : swap.before];
+    std::replace(pixels.begin(), pixels.end(), from, to);
+  }
+  auto write = [&](const Span &span) {
+    const auto &colour = delta.palette[forward ? span.after : span.before];
+    std::fill_n(pixels.begin() + span.start, span.length, colour);
+  };
+  if (forward) {
+    std::for_each(delta.spans.begin(), delta.spans.end(), write);
+  } else {
+    std::for_each(delta.spans.rbegin(), delta.spans.rend(), write);
+  }
+}
+
+void EditHistory::push(Edit &&edit, const std::string &name) {
+  if (edit.empty()) {
+    return;
+  }
+  Delta delta{name, std::move(edit.palette), std::move(edit.spans), {}};
+  compact(delta, edit.pixels);
+  for (const auto &dropped : redoStack) {
+    usedBytes -= dropped.bytes();
+  }
+  redoStack.clear();
+  usedBytes += delta.bytes();
+  undoStack.push_back(std::move(delta));
+  while (usedBytes > budgetBytes && undoStack.size() > 1) {
+    usedBytes -= undoStack.front().bytes();
+    undoStack.pop_front();
+  }
+}
+
+EditHistory::Changes EditHistory::undo(std::vector<Fwg::Gfx::Colour> &pixels) {
+  if (undoStack.empty()) {
+    return {};
+  }
+  auto delta = std::move(undoStack.back());
+  undoStack.pop_back();
+  patch(delta, pixels, false);
+  auto changes = delta.changes();
+  redoStack.push_back(std::move(delta));
+  return changes;
+}
+
+EditHistory::Changes EditHistory::redo(std::vector<Fwg::Gfx::Colour> &pixels) {
+  if (redoStack.empty()) {
+    return {};
+  }
+  auto delta = std::move(redoStack.back());
+  redoStack.pop_back();
+  patch(delta, pixels, true);
+  auto changes = delta.changes();
+  undoStack.push_back(std::move(delta));
+  return changes;
+}
+
+void EditHistory::clear() {
+  undoStack.clear();
+  redoStack.clear();
+  usedBytes = 0;
+}
+
+bool EditHistory::showControls(
+    std::vector<Fwg::Gfx::Colour> &pixels,
+    std::set<Fwg::Gfx::Colour> &highlighted,
+    const std::function<bool(const Fwg::Gfx::Colour &)> &isInput) {
+  const auto &io = ImGui::GetIO();
+  const bool shortcut = io.KeyCtrl && !io.WantTextInput;
+  bool undoPressed = shortcut && ImGui::IsKeyPressed(ImGuiKey_Z, false) &&
+                     !io.KeyShift;
+  bool redoPressed = shortcut && (ImGui::IsKeyPressed(ImGuiKey_Y, false) ||
+                                  (io.KeyShift &&
+                                   ImGui::IsKeyPressed(ImGuiKey_Z, false)));
+
+  ImGui::BeginDisabled(!canUndo());
+  undoPressed |= ImGui::Button(
+      (canUndo() ? "Undo " + undoStack.back().name + "###undo" : "Undo###undo")
+          .c_str());
+  ImGui::EndDisabled();
+  ImGui::SameLine();
+  ImGui::BeginDisabled(!canRedo());
+  redoPressed |= ImGui::Button(
+      (canRedo() ? "Redo " + redoStack.back().name + "###redo" : "Redo###redo")
+          .c_str());
+  ImGui::EndDisabled();
+  ImGui::SameLine();
+  ImGui::TextDisabled("(%zu KB history)", usedBytes / 1024);
+
+  if (undoPressed && canUndo()) {
+    for (const auto &[before, after] : undo(pixels)) {
+      if (isInput(before)) {
+        highlighted.insert(before);
+      }
+    }
+    return true;
+  }
+  if (redoPressed && canRedo()) {
+    for (const auto &[before, after] : redo(pixels)) {
+      highlighted.erase(before);
+    }
+    return true;
+  }
+  return false;
+}
+
+} // namespace Fwg::UI
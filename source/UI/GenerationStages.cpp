@@ -0,0 +1,683 @@
+#include "UI/GenerationStages.h"
+#include "UI/ColdLayers.h"
+#include "UI/Hashing.h"
+#include "UI/HeightmapCache.h"
+#include "UI/SessionJournal.h"
+#include "UI/Snapshots.h"
+#include "UI/Staleness.h"
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <map>
+#include <limits>
+#include <optional>
+#include <random>
+#include <sstream>
+
+namespace Fwg::UI::Stages {
+
+void DataSnapshot::capture(const Fwg::FastWorldGenerator &fwg,
+                           unsigned int groups) {
+  this->groups = groups;
+  if (groups & TERRAIN) {
+    terrainData = fwg.terrainData;
+    coldLayers = ColdLayers::shared().state();
+  }
+  if (groups & CLIMATE) {
+    climateData = fwg.climateData;
+  }
+  if (groups & AREAS) {
+    areaData = fwg.areaData;
+    segmentMap = fwg.segmentMap;
+    provinceMap = fwg.provinceMap;
+  }
+  if (groups & IMAGES) {
+    worldMap = fwg.worldMap;
+    segmentMap = fwg.segmentMap;
+    provinceMap = fwg.provinceMap;
+    errorMap = fwg.errorMap;
+  }
+}
+
+void DataSnapshot::restore(Fwg::FastWorldGenerator &fwg) const {
+  if (groups & TERRAIN) {
+    fwg.terrainData = terrainData;
+    ColdLayers::shared().restore(coldLayers);
+  }
+  if (groups & CLIMATE) {
+    fwg.climateData = climateData;
+  }
+  if (groups & AREAS) {
+    fwg.areaData = areaData;
+    fwg.segmentMap = segmentMap;
+    fwg.provinceMap = provinceMap;
+  }
+  if (groups & IMAGES) {
+    fwg.worldMap = worldMap;
+    fwg.segmentMap = segmentMap;
+    fwg.provinceMap = provinceMap;
+    fwg.errorMap = errorMap;
+  }
+}
+
+static const std::vector<Stage> &allStages() {
+  static const std::vector<Stage> stages = {
+      {StageId::HEIGHTMAP,
+       "Heightmap",
+       TERRAIN,
+       {},
+       [](const Fwg::Cfg &cfg) { return heightmapChain(cfg).back(); },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         // new layers replace any held ones, a backup of the run keeps those
+         ColdLayers::shared().discard(true);
+         // an unchanged pipeline state restores its earlier result
+         auto &cache = HeightmapCache::shared();
+         const auto chain = heightmapChain(cfg);
+         if (!cache.restore(chain.back(), fwg)) {
+           fwg.genHeight();
+           // lean memory keeps no second copy of the layers
+           if (ColdLayers::shared().mode == LeanMode::OFF) {
+             cache.store(chain.back(), fwg);
+           }
+         }
+         cache.setCurrent(chain);
+         return true;
+       }},
+      {StageId::LAND,
+       "Land",
+       TERRAIN,
+       {StageId::HEIGHTMAP},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.landInputMode, cfg.seaLevel,
+                                cfg.lakeMaxShare, Hashing::landforms(cfg));
+       },
+       [](Fwg::Cfg &, Fwg::FastWorldGenerator &fwg) {
+         // the land stage is the last reader of the noise layers
+         auto &coldLayers = ColdLayers::shared();
+         if (!coldLayers.thaw(fwg)) {
+           Fwg::Utils::Logging::logLine(
+               "ERROR: The noise layers were lost, run the heightmap again");
+           return false;
+         }
+         fwg.genLand();
+         coldLayers.freeze(fwg);
+         return true;
+       }},
+      {StageId::NORMALMAP,
+       "Normalmap",
+       TERRAIN,
+       {StageId::LAND},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.sobelFactor);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genSobelMap(cfg);
+         return true;
+       },
+       {},
+       // a filter of the finished heightmap into sobelData, which only the
+       // normal map tab reads
+       true},
+      {StageId::TEMPERATURE,
+       "Temperature",
+       CLIMATE,
+       {StageId::LAND},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.baseTemperature, cfg.latHigh, cfg.latLow,
+                                cfg.fantasyClimate,
+                                cfg.fantasyClimateFrequency);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genTemperatures(cfg);
+         return true;
+       }},
+      {StageId::HUMIDITY,
+       "Humidity",
+       CLIMATE,
+       {StageId::LAND},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.baseHumidity, cfg.latHigh, cfg.latLow,
+                                cfg.fantasyClimate,
+                                cfg.fantasyClimateFrequency);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genHumidity(cfg);
+         return true;
+       }},
+      {StageId::RIVERS,
+       "Rivers",
+       CLIMATE,
+       {StageId::HUMIDITY},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.riverFactor);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genRivers(cfg);
+         return true;
+       }},
+      {StageId::CLIMATE,
+       "Climate",
+       CLIMATE,
+       {StageId::TEMPERATURE, StageId::HUMIDITY, StageId::RIVERS},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.fantasyClimate, cfg.riverHumidityFactor,
+                                cfg.riverEffectRangeFactor);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genClimate(cfg);
+         return true;
+       }},
+      {StageId::FORESTS,
+       "Forests",
+       CLIMATE,
+       {StageId::CLIMATE},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.borealDensity, cfg.temperateNeedleDensity,
+                                cfg.temperateMixedDensity, cfg.sparseDensity,
+                                cfg.tropicalDryDensity,
+                                cfg.tropicalMoistDensity);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genForests(cfg);
+         return true;
+       }},
+      {StageId::WORLDMAP,
+       "World map",
+       IMAGES,
+       {StageId::CLIMATE, StageId::RIVERS},
+       [](const Fwg::Cfg &) { return std::size_t(0); },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genWorldMap(cfg);
+         return true;
+       }},
+      {StageId::HABITABILITY,
+       "Habitability",
+       CLIMATE,
+       {StageId::CLIMATE},
+       [](const Fwg::Cfg &) { return std::size_t(0); },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genHabitability(cfg);
+         return true;
+       }},
+      {StageId::SUPERSEGMENTS,
+       "SuperSegments",
+       AREAS | IMAGES,
+       {StageId::HABITABILITY},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.targetLandRegionAmount,
+                                cfg.targetSeaRegionAmount);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genSuperSegments(cfg);
+         return true;
+       }},
+      {StageId::SEGMENTS,
+       "Segments",
+       AREAS | IMAGES,
+       {StageId::SUPERSEGMENTS},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.segmentCostInfluence,
+                                cfg.segmentDistanceInfluence,
+                                cfg.targetLandRegionAmount,
+                                cfg.targetSeaRegionAmount);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genSegments(cfg);
+         return true;
+       },
+       [](const Fwg::FastWorldGenerator &fwg) -> const Fwg::Gfx::Image & {
+         return fwg.segmentMap;
+       }},
+      {StageId::PROVINCES,
+       "Provinces",
+       AREAS | IMAGES,
+       {StageId::SEGMENTS},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.landProvFactor, cfg.seaProvFactor,
+                                cfg.provinceDensityEffects, cfg.minProvSize,
+                                cfg.maxProvAmount);
+       },
+       [](Fwg::Cfg &, Fwg::FastWorldGenerator &fwg) {
+         return static_cast<bool>(fwg.genProvinces());
+       },
+       [](const Fwg::FastWorldGenerator &fwg) -> const Fwg::Gfx::Image & {
+         return fwg.provinceMap;
+       }},
+      {StageId::CONTINENTS,
+       "Continents",
+       AREAS,
+       {StageId::PROVINCES},
+       [](const Fwg::Cfg &cfg) {
+         return Hashing::values(cfg.maxAmountOfContinents);
+       },
+       [](Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+         fwg.genContinents(cfg);
+         return true;
+       }}};
+  return stages;
+}
+
+const Stage &get(StageId id) { return allStages()[static_cast<int>(id)]; }
+
+std::vector<Stage> worldStages() { return allStages(); }
+
+std::vector<Stage> climateStages() {
+  return {get(StageId::TEMPERATURE), get(StageId::HUMIDITY),
+          get(StageId::RIVERS), get(StageId::CLIMATE),
+          get(StageId::WORLDMAP)};
+}
+
+std::vector<Stage> areaStages() {
+  return {get(StageId::HABITABILITY), get(StageId::SUPERSEGMENTS),
+          get(StageId::SEGMENTS), get(StageId::PROVINCES),
+          get(StageId::CONTINENTS)};
+}
+
+// A single stage can't be interrupted, so only chains are cancellable. Their
+// backup is also what a failed stage rolls back to.
+static bool cancellable(const std::vector<Stage> &stages,
+                        const RunOptions &options) {
+  return options.cancellation && stages.size() > 1;
+}
+
+// takes the backup for a cancellable run and resets the data if requested,
+// returns whether there is a backup to roll back to
+static bool prepareRun(const std::vector<Stage> &stages,
+                       Fwg::FastWorldGenerator &fwg, const RunOptions &options,
+                       DataSnapshot &backup) {
+  unsigned int groups =
+      options.resetData ? (TERRAIN | CLIMATE | AREAS | IMAGES) : 0;
+  for (const auto &stage : stages) {
+    groups |= stage.writes;
+  }
+  // a backup is only worth its memory if the run can be cancelled
+  const bool backedUp = cancellable(stages, options);
+  if (backedUp) {
+    backup.capture(fwg, groups);
+    options.cancellation->setCancellable(true);
+  }
+  if (options.resetData) {
+    fwg.resetData();
+  }
+  return backedUp;
+}
+
+// brings back the data from before the run
+static void rollBack(const DataSnapshot &backup,
+                     Fwg::FastWorldGenerator &fwg) {
+  Fwg::Utils::Logging::logLine("Restoring the data from before the run");
+  backup.restore(fwg);
+}
+
+// The backup can't restore area objects an area stage changed, so starting
+// one ends the part of the run that can be rolled back. Returns whether the
+// backup is still usable.
+static bool keepsBackup(const Stage &stage, const RunOptions &options,
+                        bool backedUp) {
+  if (backedUp && (stage.writes & AREAS)) {
+    options.cancellation->setCancellable(false);
+    return false;
+  }
+  return backedUp;
+}
+
+// runs a stage, an exception counts as a failure
+static bool runSafely(const Stage &stage, Fwg::Cfg &cfg,
+                      Fwg::FastWorldGenerator &fwg) {
+  try {
+    return stage.run(cfg, fwg);
+  } catch (const std::exception &e) {
+    Fwg::Utils::Logging::logLine("ERROR: ", e.what());
+    return false;
+  }
+}
+
+// Publishes a new data view and hands the map the finished stage filled to
+// the live preview channel. The frame shares its pixels with the view where
+// the view holds the map, so a map is copied once per stage. The generator
+// has no callback for partial results and writes its maps in place, so
+// frames are only taken once the stage is done with them. Only the thread
+// running the stages publishes, so there is one producer.
+static void publishStage(const Stage &stage,
+                         const Fwg::FastWorldGenerator &fwg,
+                         const RunOptions &options) {
+  std::shared_ptr<const Fwg::Gfx::Image> frame;
+  if (options.snapshots) {
+    frame = Snapshots::stageMap(*options.snapshots->publish(fwg, stage.id),
+                                stage.id);
+  }
+  if (!stage.preview || !options.livePreview) {
+    return;
+  }
+  if (!frame) {
+    frame = std::make_shared<const Fwg::Gfx::Image>(stage.preview(fwg));
+  }
+  options.livePreview->writeBuffer() = std::move(frame);
+  options.livePreview->publish();
+}
+
+using FinishedStages = std::vector<std::pair<StageId, std::size_t>>;
+
+// hands the stages that finished, with the inputs they ran with, to the
+// staleness tracker in completion order
+static void recordRun(const RunOptions &options,
+                      const FinishedStages &finished) {
+  if (!options.staleness) {
+    return;
+  }
+  if (options.resetData) {
+    options.staleness->clear();
+  }
+  for (const auto &[id, inputHash] : finished) {
+    options.staleness->markComputed(id, inputHash);
+  }
+}
+
+// keeps the stages that finished before one failed, whose data the failure
+// left behind is dropped
+static void recordFailure(const RunOptions &options,
+                          const FinishedStages &finished, StageId failed) {
+  recordRun(options, finished);
+  if (options.staleness) {
+    options.staleness->forget(failed);
+  }
+}
+
+std::mutex &randomMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+void reseed(Fwg::Cfg &cfg) {
+  cfg.randomSeed = false;
+  cfg.reRandomize();
+}
+
+int newSeed() {
+  static std::mt19937 engine(std::random_device{}());
+  std::uniform_int_distribution<int> anySeed(
+      0, std::numeric_limits<int>::max());
+  return anySeed(engine);
+}
+
+bool runStages(const std::vector<Stage> &stages, Fwg::Cfg &cfg,
+               Fwg::FastWorldGenerator &fwg, const RunOptions &options) {
+  std::lock_guard<std::mutex> random(randomMutex());
+  reseed(cfg);
+  std::vector<std::string> stageNames;
+  for (const auto &stage : stages) {
+    stageNames.push_back(stage.name);
+  }
+  if (options.journal) {
+    options.journal->recordJob(options.jobName, stages, false);
+  }
+  DataSnapshot backup;
+  bool backedUp = prepareRun(stages, fwg, options, backup);
+
+  const int jobId =
+      options.progress
+          ? options.progress->beginJob(options.jobName, stageNames,
+                                       (long long)cfg.width * cfg.height)
+          : -1;
+  auto finish = [&](bool result) {
+    if (options.progress) {
+      options.progress->endJob(jobId);
+    }
+    return result;
+  };
+  auto cancelled = [&]() {
+    if (!backedUp || !options.cancellation->isCancelled()) {
+      return false;
+    }
+    Fwg::Utils::Logging::logLine("Generation cancelled");
+    rollBack(backup, fwg);
+    return true;
+  };
+
+  FinishedStages finished;
+  for (int i = 0; i < (int)stages.size(); i++) {
+    if (cancelled()) {
+      return finish(false);
+    }
+    if (options.progress) {
+      options.progress->beginStage(jobId, i);
+    }
+    const auto inputHash = stages[i].inputs(cfg);
+    backedUp = keepsBackup(stages[i], options, backedUp);
+    if (!runSafely(stages[i], cfg, fwg)) {
+      Fwg::Utils::Logging::logLine("Stage ", stages[i].name, " failed");
+      if (backedUp) {
+        rollBack(backup, fwg);
+      } else {
+        recordFailure(options, finished, stages[i].id);
+      }
+      return finish(false);
+    }
+    finished.push_back({stages[i].id, inputHash});
+    publishStage(stages[i], fwg, options);
+    if (options.progress) {
+      options.progress->endStage(jobId, i);
+    }
+  }
+  if (cancelled()) {
+    return finish(false);
+  }
+  recordRun(options, finished);
+  return finish(true);
+}
+
+bool runStage(StageId id, Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+              const RunOptions &options) {
+  return runStages({get(id)}, cfg, fwg, options);
+}
+
+std::string GraphReport::toString() const {
+  std::stringstream text;
+  text << "Critical path: ";
+  for (size_t i = 0; i < criticalPath.size(); i++) {
+    text << (i ? " -> " : "") << get(criticalPath[i]).name;
+  }
+  text.precision(3);
+  text << " (" << criticalSeconds << "s of " << wallSeconds << "s total)";
+  return text.str();
+}
+
+GraphReport runGraph(const std::vector<Stage> &stages, Fwg::Cfg &cfg,
+                     Fwg::FastWorldGenerator &fwg, const RunOptions &options,
+                     bool concurrent) {
+  using Clock = std::chrono::steady_clock;
+  struct Node {
+    int pendingDependencies = 0;
+    std::vector<int> dependents;
+    bool started = false;
+    bool done = false;
+    double seconds = 0.0;
+  };
+  struct Running {
+    int index;
+    std::size_t inputHash;
+    Clock::time_point start;
+    std::future<bool> result;
+  };
+
+  std::lock_guard<std::mutex> random(randomMutex());
+  reseed(cfg);
+  GraphReport report;
+  const auto runStart = Clock::now();
+  if (options.journal) {
+    options.journal->recordJob(options.jobName, stages, concurrent);
+  }
+  DataSnapshot backup;
+  bool backedUp = prepareRun(stages, fwg, options, backup);
+
+  std::map<StageId, int> indices;
+  for (int i = 0; i < (int)stages.size(); i++) {
+    indices[stages[i].id] = i;
+  }
+  std::vector<Node> nodes(stages.size());
+  for (int i = 0; i < (int)stages.size(); i++) {
+    for (auto dependency : stages[i].dependencies) {
+      if (indices.contains(dependency)) {
+        nodes[i].pendingDependencies++;
+        nodes[indices[dependency]].dependents.push_back(i);
+      }
+    }
+  }
+
+  // one job for the whole graph, overlapping stages report into it
+  std::vector<std::string> stageNames;
+  for (const auto &stage : stages) {
+    stageNames.push_back(stage.name);
+  }
+  const int jobId =
+      options.progress
+          ? options.progress->beginJob(options.jobName, stageNames,
+                                       (long long)cfg.width * cfg.height)
+          : -1;
+  std::vector<Running> running;
+  // finished stages report their index here, so waiting needs no polling
+  std::mutex doneMutex;
+  std::condition_variable doneSignal;
+  std::vector<int> doneQueue;
+  auto launch = [&](int i) {
+    const bool success = runSafely(stages[i], cfg, fwg);
+    {
+      std::lock_guard<std::mutex> lock(doneMutex);
+      doneQueue.push_back(i);
+    }
+    doneSignal.notify_one();
+    return success;
+  };
+  // at most one stage that shares the generator's data runs at a time
+  auto canStart = [&](int i) {
+    if (running.empty() || (concurrent && stages[i].isolated)) {
+      return true;
+    }
+    return concurrent &&
+           std::all_of(running.begin(), running.end(),
+                       [&](const Running &entry) {
+                         return stages[entry.index].isolated;
+                       });
+  };
+  std::vector<int> completionOrder;
+  FinishedStages finished;
+  bool failed = false;
+  std::optional<StageId> failedStage;
+  auto isCancelled = [&]() {
+    return backedUp && options.cancellation->isCancelled();
+  };
+
+  while (true) {
+    // start everything that is ready, in list order
+    for (int i = 0; i < (int)stages.size() && !failed && !isCancelled();
+         i++) {
+      if (nodes[i].started || nodes[i].pendingDependencies > 0 ||
+          !canStart(i)) {
+        continue;
+      }
+      nodes[i].started = true;
+      backedUp = keepsBackup(stages[i], options, backedUp);
+      if (options.progress) {
+        options.progress->beginStage(jobId, i);
+      }
+      running.push_back({i, stages[i].inputs(cfg), Clock::now(),
+                         std::async(std::launch::async, launch, i)});
+    }
+    if (running.empty()) {
+      break;
+    }
+
+    // wait for any running stage to finish
+    int doneIndex = -1;
+    {
+      std::unique_lock<std::mutex> lock(doneMutex);
+      doneSignal.wait(lock, [&] { return !doneQueue.empty(); });
+      doneIndex = doneQueue.front();
+      doneQueue.erase(doneQueue.begin());
+    }
+    const auto finishedStage =
+        std::find_if(running.begin(), running.end(),
+                     [doneIndex](const Running &entry) {
+                       return entry.index == doneIndex;
+                     });
+    const int index = finishedStage->index;
+    const auto inputHash = finishedStage->inputHash;
+    auto &node = nodes[index];
+    node.seconds =
+        std::chrono::duration<double>(Clock::now() - finishedStage->start)
+            .count();
+    const bool success = finishedStage->result.get();
+    running.erase(finishedStage);
+    if (options.progress && success) {
+      options.progress->endStage(jobId, index);
+    }
+    if (!success) {
+      Fwg::Utils::Logging::logLine("Stage ", stages[index].name, " failed");
+      failed = true;
+      failedStage = stages[index].id;
+      continue;
+    }
+    node.done = true;
+    completionOrder.push_back(index);
+    finished.push_back({stages[index].id, inputHash});
+    publishStage(stages[index], fwg, options);
+    for (auto dependent : node.dependents) {
+      nodes[dependent].pendingDependencies--;
+    }
+  }
+  report.wallSeconds =
+      std::chrono::duration<double>(Clock::now() - runStart).count();
+  if (options.progress) {
+    options.progress->endJob(jobId);
+  }
+
+  if (isCancelled() || (failed && backedUp)) {
+    if (!failed) {
+      Fwg::Utils::Logging::logLine("Generation cancelled");
+    }
+    rollBack(backup, fwg);
+    return report;
+  }
+  report.finished = !failed;
+  if (failedStage) {
+    recordFailure(options, finished, *failedStage);
+  } else {
+    recordRun(options, finished);
+  }
+
+  // completion order is a topological order, so one pass finds the longest
+  // chain of dependent stages
+  std::vector<double> chainEnd(stages.size(), 0.0);
+  std::vector<int> predecessor(stages.size(), -1);
+  int last = -1;
+  for (auto index : completionOrder) {
+    for (auto dependency : stages[index].dependencies) {
+      if (!indices.contains(dependency)) {
+        continue;
+      }
+      const int dependencyIndex = indices[dependency];
+      if (chainEnd[dependencyIndex] > chainEnd[index]) {
+        chainEnd[index] = chainEnd[dependencyIndex];
+        predecessor[index] = dependencyIndex;
+      }
+    }
+    chainEnd[index] += nodes[index].seconds;
+    if (last < 0 || chainEnd[index] > chainEnd[last]) {
+      last = index;
+    }
+  }
+  if (last >= 0) {
+    report.criticalSeconds = chainEnd[last];
+    for (int index = last; index >= 0; index = predecessor[index]) {
+      report.criticalPath.insert(report.criticalPath.begin(),
+                                 stages[index].id);
+    }
+  }
+  Fwg::Utils::Logging::logLine(report.toString());
+  if (options.progress) {
+    options.progress->setSummary(report.toString());
+  }
+  return report;
+}
+
+} // namespace Fwg::UI::Stages
@@ -0,0 +1,56 @@
+#include "UI/Hashing.h"
+#include "UI/ConfigFields.h"
+
+namespace Fwg::UI::Hashing {
+
+std::size_t layer(const LayerConfig &layer) {
+  return values(layer.type, layer.noiseType, layer.fractalType,
+                layer.fractalFrequency, layer.fractalOctaves,
+                layer.fractalGain, layer.seed, layer.weight, layer.minHeight,
+                layer.maxHeight, layer.tanFactor, layer.edgeFadeWidth,
+                layer.edgeFadeHeight, layer.altitudeWeightStart,
+                layer.altitudeWeightEnd);
+}
+
+std::size_t layers(const std::vector<LayerConfig> &layers) {
+  std::size_t seed = layers.size();
+  for (const auto &entry : layers) {
+    combine(seed, layer(entry));
+  }
+  return seed;
+}
+
+std::size_t operation(const Fwg::Terrain::HeightmapOperation &operation) {
+  using Kind = ConfigFields::OperationParameter::Kind;
+  // getParameter works on mutable operations
+  auto op = operation;
+  std::size_t seed = values(op.type, op.enabled);
+  for (const auto &parameter : ConfigFields::operationParameters(op.type)) {
+    switch (parameter.kind) {
+    case Kind::INT:
+      add(seed, Fwg::Terrain::getParameter<int>(
+                    op, parameter.name, static_cast<int>(parameter.fallback)));
+      break;
+    case Kind::BOOL:
+      add(seed, Fwg::Terrain::getParameter<bool>(op, parameter.name,
+                                                 parameter.fallback != 0.0f));
+      break;
+    default:
+      add(seed, Fwg::Terrain::getParameter<float>(op, parameter.name,
+                                                  parameter.fallback));
+      break;
+    }
+  }
+  return seed;
+}
+
+std::size_t landforms(const Fwg::Cfg &cfg) {
+  std::size_t seed = 0;
+  for (const auto &definition : cfg.terrainConfig.landformDefinitions) {
+    add(seed, definition.name);
+    add(seed, definition.landformFactor);
+  }
+  return seed;
+}
+
+} // namespace Fwg::UI::Hashing
@@ -0,0 +1,281 @@
+#include "UI/Headless.h"
+#include "UI/IsolatedRun.h"
+#include "UI/SessionJournal.h"
+#include <algorithm>
+#include <atomic>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <cstdlib>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+namespace Fwg::UI::Headless {
+
+static std::vector<std::string> splitList(const std::string &list) {
+  std::vector<std::string> items;
+  std::stringstream stream(list);
+  std::string item;
+  while (std::getline(stream, item, ',')) {
+    if (!item.empty()) {
+      items.push_back(item);
+    }
+  }
+  return items;
+}
+
+bool parseArguments(int argc, char *argv[], Options &options) {
+  if (argc > 0) {
+    std::error_code error;
+    options.executable = std::filesystem::absolute(argv[0], error).string();
+  }
+  for (int i = 1; i < argc; i++) {
+    const std::string flag = argv[i];
+    // every flag apart from --headless takes one value
+    if (flag == "--headless") {
+      options.enabled = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      Fwg::Utils::Logging::logLine("Missing value for ", flag);
+      return false;
+    }
+    const std::string value = argv[++i];
+    try {
+      if (flag == "--seeds") {
+        for (const auto &seed : splitList(value)) {
+          options.seeds.push_back(std::stoi(seed));
+        }
+      } else if (flag == "--seed-range") {
+        const auto range = splitList(value);
+        if (range.size() != 2) {
+          Fwg::Utils::Logging::logLine("--seed-range takes first,count");
+          return false;
+        }
+        const int first = std::stoi(range[0]);
+        for (int seed = 0; seed < std::stoi(range[1]); seed++) {
+          options.seeds.push_back(first + seed);
+        }
+      } else if (flag == "--configs") {
+        options.configs = splitList(value);
+      } else if (flag == "--threads") {
+        options.threads = std::max(1, std::stoi(value));
+      } else if (flag == "--replay") {
+        options.replayFile = value;
+        options.enabled = true;
+      } else if (flag == "--out") {
+        options.outputFolder = value;
+      } else if (flag == "--size") {
+        const auto size = splitList(value);
+        if (size.size() != 2) {
+          Fwg::Utils::Logging::logLine("--size takes width,height");
+          return false;
+        }
+        options.width = std::stoi(size[0]);
+        options.height = std::stoi(size[1]);
+      } else {
+        Fwg::Utils::Logging::logLine("Unknown argument ", flag);
+        return false;
+      }
+    } catch (const std::exception &) {
+      Fwg::Utils::Logging::logLine("Invalid value ", value, " for ", flag);
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace {
+struct World {
+  std::string name;
+  // config folder read on top of the loaded config, empty for none
+  std::string config;
+  Fwg::Cfg settings;
+};
+} // namespace
+
+static void writeMaps(const std::string &folder, const Fwg::Cfg &settings,
+                      const Fwg::FastWorldGenerator &generator) {
+  using HeightField = std::remove_cvref_t<decltype(
+      generator.terrainData.detailedHeightMap)>;
+  const auto &heights = generator.terrainData.detailedHeightMap;
+  if (heights.size() ==
+      static_cast<std::size_t>(settings.width) * settings.height) {
+    Fwg::Gfx::Png::save(Fwg::Gfx::Image(settings.width, settings.height, 24,
+                                        HeightField(heights)),
+                        folder + "heightmap.png");
+  }
+  auto save = [&](const Fwg::Gfx::Image &image, const std::string &name) {
+    if (image.initialised()) {
+      Fwg::Gfx::Png::save(image, folder + name);
+    }
+  };
+  save(generator.worldMap, "worldMap.png");
+  save(generator.segmentMap, "segments.png");
+  save(generator.provinceMap, "provinces.png");
+}
+
+static void writeTimings(const std::string &folder, const World &world,
+                         const Stages::IsolatedResult &result) {
+  namespace pt = boost::property_tree;
+  pt::ptree root;
+  root.put("name", world.name);
+  root.put("seed", world.settings.mapSeed);
+  root.put("width", world.settings.width);
+  root.put("height", world.settings.height);
+  root.put("finished", result.finished);
+  root.put("totalSeconds", result.seconds);
+  pt::ptree stages;
+  for (const auto &[name, seconds] : result.stageSeconds) {
+    pt::ptree stage;
+    stage.put("name", name);
+    stage.put("seconds", seconds);
+    stages.push_back({"", stage});
+  }
+  root.add_child("stages", stages);
+  pt::write_json(folder + "timings.json", root);
+}
+
+// Generates one world in a new process of this program, which has a random
+// generator of its own. Returns the exit code of the process.
+static int runProcess(const Options &options, const World &world,
+                      const std::string &outputFolder) {
+  auto quoted = [](const std::string &text) { return "\"" + text + "\""; };
+  std::ostringstream command;
+  command << quoted(options.executable) << " --headless --threads 1 --seeds "
+          << world.settings.mapSeed << " --out " << quoted(outputFolder);
+  if (!world.config.empty()) {
+    command << " --configs " << quoted(world.config);
+  }
+  if (options.width > 0 && options.height > 0) {
+    command << " --size " << options.width << ',' << options.height;
+  }
+#if defined(_WIN32)
+  // cmd strips the outermost quotes of the command line
+  return std::system(quoted(command.str()).c_str());
+#else
+  return std::system(command.str().c_str());
+#endif
+}
+
+int replay(const Options &options, const Fwg::Cfg &cfg) {
+  std::vector<Journal::Entry> entries;
+  if (!Journal::load(options.replayFile, entries)) {
+    return -1;
+  }
+  Fwg::Cfg settings = cfg;
+  if (options.width > 0 && options.height > 0) {
+    settings.width = options.width;
+    settings.height = options.height;
+  }
+  Fwg::FastWorldGenerator generator;
+  const auto latencies = Journal::replay(entries, settings, generator);
+  const auto folder =
+      options.outputFolder.empty()
+          ? std::filesystem::path(options.replayFile).parent_path().string()
+          : options.outputFolder;
+  const auto report =
+      (std::filesystem::path(folder) / "replayLatencies.json").string();
+  if (!Journal::writeReport(report, latencies)) {
+    return 1;
+  }
+  Fwg::Utils::Logging::logLine("Wrote replay latencies to ", report);
+  const bool finished =
+      std::all_of(latencies.begin(), latencies.end(),
+                  [](const Journal::Latency &latency) {
+                    return latency.finished;
+                  });
+  return finished ? 0 : 1;
+}
+
+int run(const Options &options, const Fwg::Cfg &cfg) {
+  if (!options.replayFile.empty()) {
+    return replay(options, cfg);
+  }
+  // reading configs touches shared state, so every world is set up here
+  // before any of them runs
+  std::vector<World> worlds;
+  std::vector<World> bases;
+  if (options.configs.empty()) {
+    bases.push_back({"default", "", cfg});
+  }
+  for (const auto &folder : options.configs) {
+    Fwg::Cfg base = cfg;
+    try {
+      base.readConfig(folder);
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Couldn't read config ", folder,
+                                   ": ", e.what());
+      return -1;
+    }
+    bases.push_back(
+        {std::filesystem::path(folder).filename().string(), folder, base});
+  }
+  for (const auto &base : bases) {
+    const auto seeds = options.seeds.empty()
+                           ? std::vector<int>{base.settings.mapSeed}
+                           : options.seeds;
+    for (const int seed : seeds) {
+      World world{base.name + "_" + std::to_string(seed), base.config,
+                  base.settings};
+      if (options.width > 0 && options.height > 0) {
+        world.settings.width = options.width;
+        world.settings.height = options.height;
+      }
+      world.settings.mapSeed = seed;
+      world.settings.randomSeed = false;
+      worlds.push_back(std::move(world));
+    }
+  }
+
+  const auto outputFolder = options.outputFolder.empty()
+                                ? cfg.mapsPath + "/batch/"
+                                : options.outputFolder + "/";
+  Fwg::Utils::Logging::logLine("Generating ", worlds.size(), " worlds, ",
+                               options.threads, " at a time, into ",
+                               outputFolder);
+  std::atomic<std::size_t> next = 0;
+  std::atomic<int> failed = 0;
+  auto worker = [&]() {
+    for (auto i = next++; i < worlds.size(); i = next++) {
+      const auto &world = worlds[i];
+      if (options.threads > 1) {
+        if (runProcess(options, world, outputFolder) != 0) {
+          failed++;
+          Fwg::Utils::Logging::logLine("ERROR: ", world.name, " failed");
+        }
+        continue;
+      }
+      const auto folder = outputFolder + world.name + "/";
+      std::error_code error;
+      std::filesystem::create_directories(folder, error);
+      try {
+        const auto result = Stages::runIsolated(
+            world.settings, Stages::worldStages(), 0,
+            [&folder](const Fwg::Cfg &settings,
+                      const Fwg::FastWorldGenerator &generator) {
+              writeMaps(folder, settings, generator);
+            });
+        writeTimings(folder, world, result);
+        failed += !result.finished;
+        Fwg::Utils::Logging::logLine("Finished ", world.name, " in ",
+                                     result.seconds, "s");
+      } catch (const std::exception &e) {
+        failed++;
+        Fwg::Utils::Logging::logLine("ERROR: ", world.name,
+                                     " failed: ", e.what());
+      }
+    }
+  };
+  {
+    std::vector<std::jthread> workers;
+    for (int i = 1; i < options.threads; i++) {
+      workers.emplace_back(worker);
+    }
+    worker();
+  }
+  return failed ? 1 : 0;
+}
+
+} // namespace Fwg::UI::Headless
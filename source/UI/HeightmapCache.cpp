@@ -0,0 +1,117 @@
+#include "UI/HeightmapCache.h"
+#include "UI/Hashing.h"
+#include "UI/MemoryLedger.h"
+
+namespace Fwg::UI::Stages {
+
+std::vector<std::size_t> heightmapChain(const Fwg::Cfg &cfg) {
+  std::vector<std::size_t> chain;
+  chain.push_back(Hashing::values(
+      cfg.width, cfg.height, cfg.mapSeed, cfg.landInputMode, cfg.seaLevel,
+      cfg.landPercentage, cfg.heightAdjustments, cfg.layerApplicationFactor,
+      cfg.maxLandHeight, cfg.heightmapFrequencyModifier,
+      cfg.globalEdgeFadeWidthModifier, cfg.globalEdgeFadeHeightModifier,
+      Hashing::layers(cfg.shapeLayers), Hashing::layers(cfg.landLayers),
+      Hashing::layers(cfg.seaLayers)));
+  for (const auto &operation : cfg.terrainConfig.heightmapPipeline.operations) {
+    auto hash = chain.back();
+    Hashing::combine(hash, Hashing::operation(operation));
+    chain.push_back(hash);
+  }
+  return chain;
+}
+
+// the whole terrain data is cached, so the noise layers count as well, they
+// are most of it
+static std::size_t estimateBytes(const Fwg::Terrain::TerrainData &data) {
+  Memory::Seen seen;
+  return Memory::heapBytes(data.detailedHeightMap, seen) +
+         Memory::heapBytes(data.landMask, seen) +
+         Memory::heapBytes(data.landFormIds, seen) +
+         Memory::heapBytes(data.sobelData, seen) +
+         Memory::heapBytes(data.shapeLayers, seen) +
+         Memory::heapBytes(data.landLayers, seen) +
+         Memory::heapBytes(data.seaLayers, seen);
+}
+
+HeightmapCache &HeightmapCache::shared() {
+  static HeightmapCache cache;
+  return cache;
+}
+
+bool HeightmapCache::restore(std::size_t key, Fwg::FastWorldGenerator &fwg) {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = entries.begin(); it != entries.end(); ++it) {
+    if (it->key == key) {
+      entries.splice(entries.begin(), entries, it);
+      fwg.terrainData = it->terrainData;
+      return true;
+    }
+  }
+  return false;
+}
+
+void HeightmapCache::store(std::size_t key,
+                           const Fwg::FastWorldGenerator &fwg) {
+  const auto bytes = estimateBytes(fwg.terrainData);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (bytes > budgetBytes) {
+    return;
+  }
+  entries.remove_if([&](const Entry &entry) {
+    if (entry.key == key) {
+      usedBytes -= entry.bytes;
+      return true;
+    }
+    return false;
+  });
+  while (!entries.empty() && usedBytes + bytes > budgetBytes) {
+    usedBytes -= entries.back().bytes;
+    entries.pop_back();
+  }
+  entries.push_front({key, fwg.terrainData, bytes});
+  usedBytes += bytes;
+}
+
+void HeightmapCache::setCurrent(const std::vector<std::size_t> &chain) {
+  std::lock_guard<std::mutex> lock(mutex);
+  currentChain = chain;
+}
+
+int HeightmapCache::unchangedOperations(const Fwg::Cfg &cfg) const {
+  const auto chain = heightmapChain(cfg);
+  std::lock_guard<std::mutex> lock(mutex);
+  if (currentChain.empty()) {
+    return -1;
+  }
+  int unchanged = 0;
+  while (unchanged + 1 < (int)chain.size() &&
+         unchanged + 1 < (int)currentChain.size() &&
+         chain[unchanged + 1] == currentChain[unchanged + 1]) {
+    unchanged++;
+  }
+  return unchanged;
+}
+
+bool HeightmapCache::contains(std::size_t key) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  for (const auto &entry : entries) {
+    if (entry.key == key) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::size_t HeightmapCache::bytes() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return usedBytes;
+}
+
+void HeightmapCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  usedBytes = 0;
+}
+
+} // namespace Fwg::UI::Stages
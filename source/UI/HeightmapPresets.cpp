@@ -0,0 +1,156 @@
+#include "UI/HeightmapPresets.h"
+#include "UI/ConfigFields.h"
+#include <boost/property_tree/json_parser.hpp>
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace Fwg::UI {
+
+std::vector<std::string> HeightmapPresets::Catalog::paths() const {
+  std::vector<std::string> paths;
+  for (const auto &[path, preset] : presets) {
+    paths.push_back(path);
+  }
+  return paths;
+}
+
+const boost::property_tree::ptree *
+HeightmapPresets::Catalog::find(const std::string &path) const {
+  const auto it = presets.find(path);
+  return it != presets.end() ? &it->second : nullptr;
+}
+
+static void keyNames(const boost::property_tree::ptree &node,
+                     std::set<std::string> &names) {
+  for (const auto &[name, child] : node) {
+    names.insert(name);
+    keyNames(child, names);
+  }
+}
+
+// The library reader only takes a path, so the preset is read onto a default
+// config and compared with it. Heightmap fields named in the file are kept
+// even if they equal the default, as are the layer counts, so a preset with
+// fewer layers removes the extra ones.
+static boost::property_tree::ptree parse(const std::string &path) {
+  std::istringstream json(Fwg::Parsing::readFile(path));
+  boost::property_tree::ptree file;
+  boost::property_tree::read_json(json, file);
+  std::set<std::string> names;
+  keyNames(file, names);
+
+  Fwg::Cfg read;
+  const auto before = ConfigFields::flatten(read);
+  read.readHeightmapConfig(path);
+  boost::property_tree::ptree fields;
+  for (const auto &[field, value] : ConfigFields::flatten(read)) {
+    const auto previous = before.find(field);
+    const bool named = field.starts_with("map.heightmap.") &&
+                       !field.starts_with("map.heightmap.pipeline.") &&
+                       (names.contains(field.substr(field.rfind('.') + 1)) ||
+                        field.ends_with("Layers.amount"));
+    if (named || previous == before.end() || previous->second != value) {
+      fields.put(field, value);
+    }
+  }
+  return fields;
+}
+
+void HeightmapPresets::readAll() {
+  auto next = std::make_shared<Catalog>();
+  if (auto previous = current.load()) {
+    next->version = previous->version + 1;
+  }
+  std::error_code error;
+  for (const auto &entry :
+       std::filesystem::directory_iterator(folder, error)) {
+    const auto path = entry.path().string();
+    if (entry.is_directory() || !path.contains(".json")) {
+      continue;
+    }
+    try {
+      next->presets[path] = parse(path);
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Couldn't read heightmap preset ",
+                                   path, ": ", e.what());
+    }
+  }
+  if (error) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't list heightmap presets in ",
+                                 folder, ": ", error.message());
+  }
+  current.store(std::move(next));
+}
+
+#if defined(__linux__)
+void HeightmapPresets::watch(std::stop_token stop) {
+  const int fd = inotify_init1(IN_NONBLOCK);
+  if (fd < 0 ||
+      inotify_add_watch(fd, folder.c_str(),
+                        IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                            IN_CREATE | IN_DELETE) < 0) {
+    Fwg::Utils::Logging::logLine("Couldn't watch ", folder,
+                                 ", presets won't refresh on changes");
+    if (fd >= 0) {
+      close(fd);
+    }
+    return;
+  }
+  char events[4096];
+  while (!stop.stop_requested()) {
+    pollfd request{fd, POLLIN, 0};
+    // a timeout, so the stop request is noticed
+    if (poll(&request, 1, 250) <= 0) {
+      continue;
+    }
+    // editors save in several steps, read once they are done
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    while (read(fd, events, sizeof(events)) > 0) {
+    }
+    readAll();
+  }
+  close(fd);
+}
+#else
+// no change notifications used here, compare the file list and times instead
+void HeightmapPresets::watch(std::stop_token stop) {
+  auto signature = [this]() {
+    std::map<std::string, std::filesystem::file_time_type> files;
+    std::error_code error;
+    for (const auto &entry :
+         std::filesystem::directory_iterator(folder, error)) {
+      files[entry.path().string()] = entry.last_write_time(error);
+    }
+    return files;
+  };
+  auto last = signature();
+  while (!stop.stop_requested()) {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    auto now = signature();
+    if (now != last) {
+      last = std::move(now);
+      readAll();
+    }
+  }
+}
+#endif
+
+void HeightmapPresets::start(const std::string &folder) {
+  if (worker.joinable()) {
+    return;
+  }
+  this->folder = folder;
+  worker = std::jthread([this](std::stop_token stop) {
+    readAll();
+    watch(stop);
+  });
+}
+
+} // namespace Fwg::UI
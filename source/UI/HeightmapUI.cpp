@@ -1,4 +1,6 @@
 #include "UI/HeightmapUI.h"
+#include "UI/ColdLayers.h"
+#include "UI/ConfigFields.h"
 
 namespace Fwg::UI {
 void HeightmapUI::configureLandElevationFactors(Fwg::Cfg &cfg,
@@ -303,10 +305,78 @@ void HeightmapUI::loadHeightmapConfigs() {
       Fwg::Utils::Logging::logLine("Found heightmap config: ", entry);
     }
   }
+  presets.start(heightmapConfigFolder);
 }
 
 
-void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
+void HeightmapUI::applyPreset(Fwg::Cfg &cfg, const std::string &path) {
+  // parsed by the preset worker, so no file is read here
+  const auto catalog = presets.catalog();
+  const auto *preset = catalog ? catalog->find(path) : nullptr;
+  if (!preset) {
+    Fwg::Utils::Logging::logLine("ERROR: Heightmap preset ", path,
+                                 " isn't loaded");
+    return;
+  }
+  ConfigFields::apply(*preset, cfg);
+}
+
+
+void HeightmapUI::showPipelineProfile(const Fwg::Cfg &cfg) {
+  if (pipelineProfiler.running()) {
+    ImGui::ProgressBar(pipelineProfiler.progress(), ImVec2(-1, 0),
+                       "Profiling operations...");
+  } else if (ImGui::Button("Profile operations", ImVec2(-1, 0))) {
+    pipelineProfiler.start(cfg);
+  }
+  const auto *profile = pipelineProfiler.profile();
+  if (!profile) {
+    return;
+  }
+  const bool outdated = profile->inputs != Stages::heightmapChain(cfg).back();
+  ImGui::Text("Total %.1f ms, without operations %.1f ms at %dx%d%s",
+              profile->totalSeconds * 1000.0, profile->baseSeconds * 1000.0,
+              profile->width, profile->height, outdated ? " (outdated)" : "");
+  ImGui::TextDisabled("Threads and memory are of the whole process");
+
+  // flame bar, every operation gets a width relative to its share of the run
+  const float width = ImGui::GetContentRegionAvail().x;
+  const float height = ImGui::GetFrameHeight();
+  const ImVec2 origin = ImGui::GetCursorScreenPos();
+  auto *drawList = ImGui::GetWindowDrawList();
+  const double total = std::max(profile->totalSeconds, 1e-9);
+  float x = origin.x;
+  auto segment = [&](const char *label, double seconds, ImU32 colour) {
+    const float w = static_cast<float>(seconds / total) * width;
+    const ImVec2 min(x, origin.y);
+    const ImVec2 max(x + w, origin.y + height);
+    drawList->AddRectFilled(min, max, colour);
+    drawList->AddRect(min, max, IM_COL32(0, 0, 0, 255));
+    if (ImGui::IsMouseHoveringRect(min, max)) {
+      ImGui::SetTooltip("%s: %.1f ms (%.0f%%)", label, seconds * 1000.0,
+                        100.0 * seconds / total);
+    }
+    x += w;
+  };
+  segment("Without operations", profile->baseSeconds,
+          IM_COL32(110, 110, 110, 255));
+  for (std::size_t i = 0; i < profile->operations.size(); i++) {
+    const auto &operation = profile->operations[i];
+    const float hue = 0.1f * static_cast<float>(i % 10);
+    segment(operation.name.c_str(), operation.seconds,
+            ImColor::HSV(hue, 0.6f, 0.9f));
+  }
+  ImGui::Dummy(ImVec2(width, height));
+
+  if (ImGui::Button("Export profile as JSON", ImVec2(-1, 0))) {
+    profile->writeJson(cfg.workingDirectory + "pipelineProfile.json");
+  }
+}
+
+
+void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg,
+                                          Fwg::FastWorldGenerator &fwg,
+                                          UIContext &uiContext) {
   // Wrap entire editor in collapsible header
   if (!ImGui::CollapsingHeader("Heightmap Processing Pipeline")) {
     return;
@@ -319,6 +389,41 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
                      "processing operations. Drag to reorder.");
   ImGui::Spacing();
 
+  // Reduced resolution preview of the edited pipeline, shown on the right
+  const bool heightmapMode =
+      cfg.landInputMode == Fwg::Terrain::InputMode::HEIGHTMAP;
+  const bool computing = uiContext.asyncContext.computationRunning;
+  if (heightmapMode) {
+    ImGui::Checkbox("Live preview", &livePreview);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/4", &pipelinePreview.scale, 4);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/8", &pipelinePreview.scale, 8);
+  }
+  if (computing) {
+    // a full run is in progress, its result replaces any preview
+    pipelinePreview.discard();
+  }
+  Fwg::Gfx::Image previewFrame;
+  if (pipelinePreview.update(cfg, previewFrame,
+                             livePreview && heightmapMode && !computing)) {
+    uiContext.imageContext.updateImage(1, std::move(previewFrame));
+  }
+  if (pendingFullRun && pipelinePreview.idle() && !computing) {
+    pendingFullRun = false;
+    pipelinePreview.discard();
+    uiContext.asyncContext.computationFutureBool =
+        uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
+          const bool finished = Stages::runStages(
+              {Stages::get(Stages::StageId::HEIGHTMAP),
+               Stages::get(Stages::StageId::LAND)},
+              cfg, fwg, uiContext.asyncContext.runOptions("Pipeline edit"));
+          uiContext.imageContext.resetTexture();
+          return finished;
+        });
+  }
+  ImGui::Spacing();
+
   // Main container - two columns
   ImGui::BeginChild("PipelineEditorContainer",
                     ImVec2(0, ImGui::GetContentRegionAvail().y * 0.5f), false,
@@ -330,8 +435,20 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
                     ImGuiWindowFlags_None);
 
   ImGui::Text("Processing Pipeline");
+  // operations before the first change match the current heightmap
+  const auto &cache = Stages::HeightmapCache::shared();
+  const int unchanged = cache.unchangedOperations(cfg);
+  if (unchanged >= 0) {
+    ImGui::TextDisabled("Green: unchanged, orange: recomputed on next run");
+    ImGui::TextDisabled("Cached results: %.1f MB",
+                        cache.bytes() / (1024.0 * 1024.0));
+  }
   ImGui::Separator();
 
+  // timings of the last profile, shown next to each operation
+  pipelineProfiler.poll();
+  const auto *profile = pipelineProfiler.profile();
+
   // Drag-drop target for reordering
   static int draggedIndex = -1;
 
@@ -347,8 +464,14 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
     ImGui::Checkbox("##enabled", &operation.enabled);
     ImGui::SameLine();
 
-    // Drag handle indicator
-    ImGui::TextDisabled(":::");
+    // Drag handle indicator, coloured by the cache state of the operation
+    if (unchanged < 0) {
+      ImGui::TextDisabled(":::");
+    } else if (i < unchanged) {
+      ImGui::TextColored(ImVec4(0.3f, 0.8f, 0.3f, 1.0f), ":::");
+    } else {
+      ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), ":::");
+    }
     ImGui::SameLine();
 
     // Selectable operation name
@@ -362,6 +485,12 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
       selectedOperationIndex = i;
     }
     ImGui::PopStyleColor();
+    if (const auto *measured = profile ? profile->find(i) : nullptr) {
+      ImGui::SameLine(ImGui::GetWindowContentRegionMax().x - 190.0f);
+      ImGui::TextDisabled("%8.1f ms %3dt %7.1f MB", measured->seconds * 1000.0,
+                          measured->processThreads,
+                          measured->processPeakBytes / (1024.0 * 1024.0));
+    }
 
     ImGui::EndGroup();
 
@@ -394,6 +523,8 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
     ImGui::PopID();
   }
 
+  ImGui::Separator();
+  showPipelineProfile(cfg);
   ImGui::Separator();
   ImGui::Spacing();
 
@@ -550,8 +681,14 @@ void HeightmapUI::configurePipelineEditor(Fwg::Cfg &cfg) {
     ImGui::Separator();
     ImGui::Spacing();
 
-    // Type-specific parameters
+    // Type-specific parameters, grouped so releasing any of their sliders
+    // can start the full resolution run
+    ImGui::BeginGroup();
     renderOperationParameters(operation);
+    ImGui::EndGroup();
+    if (ImGui::IsItemDeactivatedAfterEdit() && livePreview && heightmapMode) {
+      pendingFullRun = true;
+    }
 
     ImGui::Spacing();
     ImGui::Separator();
@@ -576,12 +713,15 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
   static int layerTypeSelection = 0; // 0=Shape, 1=Land, 2=Sea
   static int previousLayerTypeSelection = 0;
 
-  if (UI::Elements::BeginSubTabItem("Heightmap")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Heightmap", uiContext.staleTab(Stages::StageId::HEIGHTMAP, cfg) ||
+                           uiContext.staleTab(Stages::StageId::LAND, cfg))) {
     if (uiContext.tabSwitchEvent()) {
 
       if (fwg.terrainData.detailedHeightMap.size()) {
-        auto heightmap =
-            Fwg::Gfx::displayHeightMap(fwg.terrainData.detailedHeightMap);
+        // both views share one image and one texture
+        auto heightmap = std::make_shared<const Fwg::Gfx::Image>(
+            Fwg::Gfx::displayHeightMap(fwg.terrainData.detailedHeightMap));
         uiContext.imageContext.updateImage(0, heightmap);
         uiContext.imageContext.updateImage(1, heightmap);
 
@@ -590,7 +730,14 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
               (layerTypeSelection == 0)   ? fwg.terrainData.shapeLayers
               : (layerTypeSelection == 1) ? fwg.terrainData.landLayers
                                           : fwg.terrainData.seaLayers;
-          if (selectedLayer < selectedLayers.size() &&
+          Stages::LayerField frozenLayer;
+          // lean memory mode took the layers out after the land stage
+          if (selectedLayers.empty() &&
+              Stages::ColdLayers::shared().peek(layerTypeSelection,
+                                                selectedLayer, frozenLayer)) {
+            uiContext.imageContext.updateImage(
+                1, Fwg::Gfx::Image(cfg.width, cfg.height, 24, frozenLayer));
+          } else if (selectedLayer < selectedLayers.size() &&
               selectedLayers[selectedLayer].size() &&
               fwg.terrainData.detailedHeightMap.size()) {
             uiContext.imageContext.updateImage(
@@ -620,6 +767,23 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     static int activeConfigIndex = -1;
     static bool initializedDefault = false;
 
+    // the preset worker noticed changed files
+    if (const auto catalog = presets.catalog();
+        catalog && catalog->version != presetsVersion) {
+      presetsVersion = catalog->version;
+      std::string active;
+      if (activeConfigIndex >= 0 &&
+          activeConfigIndex < heightmapConfigFiles.size()) {
+        active = heightmapConfigFiles[activeConfigIndex];
+      }
+      heightmapConfigFiles = catalog->paths();
+      const auto found = std::find(heightmapConfigFiles.begin(),
+                                   heightmapConfigFiles.end(), active);
+      activeConfigIndex = found != heightmapConfigFiles.end()
+                              ? (int)(found - heightmapConfigFiles.begin())
+                              : -1;
+    }
+
     // Initialize with default config on first run
     if (!initializedDefault && heightmapConfigFiles.size() > 0) {
       // Try to find "default.json" in the list
@@ -650,7 +814,7 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         bool isActive = (i == activeConfigIndex);
         if (ImGui::Selectable(heightmapConfigFiles[i].c_str(), isActive)) {
           activeConfigIndex = i;
-          cfg.readHeightmapConfig(heightmapConfigFiles[i]);
+          applyPreset(cfg, heightmapConfigFiles[i]);
         }
         if (isActive)
           ImGui::SetItemDefaultFocus();
@@ -659,6 +823,45 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     }
     ImGui::PopItemWidth();
 
+    // Every preset rendered small with the current seed, click to apply
+    if (ImGui::CollapsingHeader("Preset Gallery")) {
+      presetGallery.update(cfg, presets);
+      const ImVec2 thumbnailSize(PresetGallery::width * 0.625f,
+                                 PresetGallery::height * 0.625f);
+      const float spacing = ImGui::GetStyle().ItemSpacing.x;
+      const int perRow = std::max(
+          1, (int)((ImGui::GetContentRegionAvail().x + spacing) /
+                   (thumbnailSize.x + spacing)));
+      for (int i = 0; i < heightmapConfigFiles.size(); ++i) {
+        const auto &path = heightmapConfigFiles[i];
+        ImGui::PushID(i);
+        ImGui::BeginGroup();
+        if (const GLuint thumbnail = presetGallery.texture(path)) {
+          ImGui::Image((ImTextureID)(intptr_t)thumbnail, thumbnailSize);
+        } else {
+          ImGui::Dummy(thumbnailSize);
+        }
+        const auto name = std::filesystem::path(path).filename().string();
+        ImGui::TextColored(i == activeConfigIndex
+                               ? ImVec4(0.3f, 0.8f, 0.3f, 1.0f)
+                               : ImVec4(0.8f, 0.8f, 0.8f, 1.0f),
+                           "%s", name.c_str());
+        ImGui::EndGroup();
+        if (ImGui::IsItemHovered()) {
+          ImGui::SetTooltip("Click to apply %s", name.c_str());
+        }
+        if (ImGui::IsItemClicked()) {
+          activeConfigIndex = i;
+          applyPreset(cfg, path);
+        }
+        ImGui::PopID();
+        if ((i + 1) % perRow != 0) {
+          ImGui::SameLine();
+        }
+      }
+      ImGui::NewLine();
+    }
+
     ImGui::Spacing();
     ImGui::SeparatorText("Basic Parameters");
 
@@ -759,12 +962,24 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
         ImGui::TextUnformatted("Layer List");
         ImGui::Separator();
 
+        layerThumbnails.collect(cfg);
+        const ImVec2 thumbnailSize(32.0f, 32.0f);
         for (int i = 0; i < currentLayers->size(); i++) {
           char label[64];
           snprintf(label, sizeof(label), "%s Layer %d", layerTypeName, i);
 
           ImGui::PushID(i);
-          if (ImGui::Selectable(label, selectedLayer == i)) {
+          // empty until the layer's render finished
+          const GLuint thumbnail = layerThumbnails.get(
+              cfg, (*currentLayers)[i], layerTypeSelection);
+          if (thumbnail) {
+            ImGui::Image((ImTextureID)(intptr_t)thumbnail, thumbnailSize);
+          } else {
+            ImGui::Dummy(thumbnailSize);
+          }
+          ImGui::SameLine();
+          if (ImGui::Selectable(label, selectedLayer == i, 0,
+                                ImVec2(0, thumbnailSize.y))) {
             selectedLayer = i;
             updateLayer = true;
             uiContext.imageContext.resetTexture(1);
@@ -917,7 +1132,7 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     ImGui::Spacing();
 
     // Pipeline Editor
-    configurePipelineEditor(cfg);
+    configurePipelineEditor(cfg, fwg, uiContext);
 
     ImGui::Spacing();
     ImGui::SeparatorText("Generation Controls");
@@ -931,15 +1146,16 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       if (UI::Elements::Button("Generate Random Continent Shape", false,
                                ImVec2(250, 0))) {
         if (rerandomiseSeed) {
-          cfg.randomSeed = true;
-          cfg.reRandomize();
+          cfg.mapSeed = Stages::newSeed();
         }
         uiContext.asyncContext.computationFutureBool =
-            uiContext.asyncContext.runAsync([&fwg, &uiContext, this]() {
-              fwg.genHeight();
+            uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext, this]() {
+              const bool finished = Stages::runStage(
+                  Stages::StageId::HEIGHTMAP, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Continent shape"));
               uiContext.imageContext.resetTexture();
               updateLayer = true;
-              return true;
+              return finished;
             });
       }
 
@@ -948,29 +1164,32 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       if (UI::Elements::Button("Generate Heightmap Details", false,
                                ImVec2(250, 0))) {
         if (rerandomiseSeed) {
-          cfg.randomSeed = true;
-          cfg.reRandomize();
+          cfg.mapSeed = Stages::newSeed();
         }
         uiContext.asyncContext.computationFutureBool =
-            uiContext.asyncContext.runAsync([&fwg, &uiContext, this]() {
-              fwg.genLand();
+            uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext, this]() {
+              const bool finished = Stages::runStage(
+                  Stages::StageId::LAND, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Heightmap details"));
               updateLayer = true;
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
 
       if (UI::Elements::ImportantStepButton(
               "Generate Complete Heightmap from new seed", ImVec2(250, 0))) {
-        cfg.randomSeed = true;
-        cfg.reRandomize();
+        cfg.mapSeed = Stages::newSeed();
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &uiContext, &cfg, this]() {
-              fwg.genHeight();
-              fwg.genLand();
+              const bool finished = Stages::runStages(
+                  {Stages::get(Stages::StageId::HEIGHTMAP),
+                   Stages::get(Stages::StageId::LAND)},
+                  cfg, fwg,
+                  uiContext.asyncContext.runOptions("Complete heightmap"));
               uiContext.imageContext.resetTexture();
               updateLayer = true;
-              return true;
+              return finished;
             });
       }
       break;
@@ -979,22 +1198,35 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     case Fwg::Terrain::InputMode::HEIGHTSKETCH: {
       if (UI::Elements::Button("Generate from Sketch", false, ImVec2(250, 0))) {
         if (rerandomiseSeed) {
-          cfg.randomSeed = true;
-          cfg.reRandomize();
+          cfg.mapSeed = Stages::newSeed();
         }
-        fwg.genHeightFromInput(cfg, cfg.mapsPath + "/heightSketchInput.png",
-                               cfg.landInputMode);
-        uiContext.imageContext.resetTexture();
+        // a job, as it holds the random generator lock while it reads
+        uiContext.asyncContext.computationFutureBool =
+            uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext]() {
+              {
+                std::lock_guard<std::mutex> random(Stages::randomMutex());
+                Stages::reseed(cfg);
+                fwg.genHeightFromInput(cfg,
+                                       cfg.mapsPath + "/heightSketchInput.png",
+                                       cfg.landInputMode);
+              }
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::HEIGHTMAP);
+              uiContext.imageContext.resetTexture();
+              return true;
+            });
       }
 
       ImGui::SameLine();
 
       if (UI::Elements::Button("Apply Detail Layers", false, ImVec2(250, 0))) {
         uiContext.asyncContext.computationFutureBool =
-            uiContext.asyncContext.runAsync([&fwg, &uiContext, this]() {
-              fwg.genLand();
+            uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext, this]() {
+              const bool finished = Stages::runStage(
+                  Stages::StageId::LAND, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Detail layers"));
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
       break;
@@ -1025,15 +1257,24 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
           UI::Elements::ImportantStepButton("Generate from Landform Input",
                                             ImVec2(250, 0))) {
         if (rerandomiseSeed) {
-          cfg.randomSeed = true;
-          cfg.reRandomize();
+          cfg.mapSeed = Stages::newSeed();
         }
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext, this]() {
-              if (fwg.genHeightFromInput(
-                      cfg, cfg.mapsPath + "/classifiedLandInput.png",
-                      cfg.landInputMode)) {
-                fwg.genLand();
+              bool loaded = false;
+              {
+                std::lock_guard<std::mutex> random(Stages::randomMutex());
+                Stages::reseed(cfg);
+                loaded = fwg.genHeightFromInput(
+                    cfg, cfg.mapsPath + "/classifiedLandInput.png",
+                    cfg.landInputMode);
+              }
+              if (loaded) {
+                uiContext.asyncContext.staleness.markLoaded(
+                    Stages::StageId::HEIGHTMAP);
+                Stages::runStage(
+                    Stages::StageId::LAND, cfg, fwg,
+                    uiContext.asyncContext.runOptions("Landform details"));
               }
               updateLayer = true;
               uiContext.imageContext.resetTexture();
@@ -1047,14 +1288,22 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       if (UI::Elements::ImportantStepButton("Generate from Landmask",
                                             ImVec2(250, 0))) {
         if (rerandomiseSeed) {
-          cfg.randomSeed = true;
-          cfg.reRandomize();
+          cfg.mapSeed = Stages::newSeed();
         }
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, &uiContext, this]() {
-              fwg.genHeightFromInput(cfg, cfg.mapsPath + "/landmaskInput.png",
-                                     cfg.landInputMode);
-              fwg.genLand();
+              {
+                std::lock_guard<std::mutex> random(Stages::randomMutex());
+                Stages::reseed(cfg);
+                fwg.genHeightFromInput(cfg,
+                                       cfg.mapsPath + "/landmaskInput.png",
+                                       cfg.landInputMode);
+              }
+              uiContext.asyncContext.staleness.markLoaded(
+                  Stages::StageId::HEIGHTMAP);
+              Stages::runStage(
+                  Stages::StageId::LAND, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Landmask details"));
               updateLayer = true;
               uiContext.imageContext.resetTexture();
               return true;
@@ -1071,8 +1320,9 @@ int HeightmapUI::showHeightmapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
     if (uiContext.triggeredDrag) {
       uiContext.triggeredDrag = false;
       cfg.allowHeightmapModification = false;
-      fwg.loadHeight(
-          cfg, IO::Reader::readHeightmapImage(uiContext.draggedFile, cfg));
+      uiContext.asyncContext.loadDrop(
+          {Drops::Target::HEIGHTMAP, uiContext.draggedFile}, cfg, fwg);
+      uiContext.asyncContext.staleness.markLoaded(Stages::StageId::HEIGHTMAP);
       uiContext.imageContext.resetTexture();
     }
 
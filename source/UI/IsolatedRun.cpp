@@ -0,0 +1,126 @@
+#include "UI/IsolatedRun.h"
+#include "UI/LayerFields.h"
+#include <algorithm>
+#include <chrono>
+#include <type_traits>
+
+namespace Fwg::UI::Stages {
+using HeightField = std::remove_cvref_t<
+    decltype(std::declval<Fwg::Terrain::TerrainData &>().detailedHeightMap)>;
+
+// 4-connected land components with at least minPixels pixels
+static int countContinents(const auto &landMask, int width, int height,
+                           std::size_t minPixels) {
+  std::vector<char> visited(landMask.size(), 0);
+  std::vector<std::size_t> open;
+  int count = 0;
+  for (std::size_t start = 0; start < landMask.size(); start++) {
+    if (!landMask[start] || visited[start]) {
+      continue;
+    }
+    std::size_t pixels = 0;
+    visited[start] = 1;
+    open.push_back(start);
+    while (!open.empty()) {
+      const auto pixel = open.back();
+      open.pop_back();
+      pixels++;
+      const int x = static_cast<int>(pixel % width);
+      const int y = static_cast<int>(pixel / width);
+      auto visit = [&](int nx, int ny) {
+        if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+          return;
+        }
+        const auto next = static_cast<std::size_t>(ny) * width + nx;
+        if (landMask[next] && !visited[next]) {
+          visited[next] = 1;
+          open.push_back(next);
+        }
+      };
+      visit(x - 1, y);
+      visit(x + 1, y);
+      visit(x, y - 1);
+      visit(x, y + 1);
+    }
+    count += pixels >= minPixels;
+  }
+  return count;
+}
+
+static Fwg::Gfx::Image thumbnail(const HeightField &heights, int width,
+                                 int height, int thumbnailWidth) {
+  const int factor = std::max(1, width / std::max(1, thumbnailWidth));
+  return Fwg::Gfx::Image(std::max(1, width / factor),
+                         std::max(1, height / factor), 24,
+                         downsample(heights, width, height, factor));
+}
+
+IsolatedResult runIsolated(
+    Fwg::Cfg settings, const std::vector<Stage> &stages, int thumbnailWidth,
+    const std::function<void(const Fwg::Cfg &,
+                             const Fwg::FastWorldGenerator &)> &inspect) {
+  using Clock = std::chrono::steady_clock;
+  IsolatedResult result;
+  Fwg::FastWorldGenerator generator;
+  settings.randomSeed = false;
+  {
+    std::lock_guard<std::mutex> random(randomMutex());
+    settings.reRandomize();
+    generator.configure(settings);
+  }
+  std::unique_lock<std::mutex> random(randomMutex(), std::defer_lock);
+  const auto start = Clock::now();
+  for (const auto &stage : stages) {
+    if (stage.id != StageId::HEIGHTMAP && !random.owns_lock()) {
+      // reseeded, so these stages draw as in a fresh run of this seed
+      random.lock();
+      settings.reRandomize();
+    }
+    const auto stageStart = Clock::now();
+    bool finished = true;
+    // the stage table versions of these also fill the caches of the main
+    // generator, which must not see results of a different config
+    if (stage.id == StageId::HEIGHTMAP) {
+      generator.genHeight();
+    } else if (stage.id == StageId::LAND) {
+      generator.genLand();
+    } else {
+      finished = stage.run(settings, generator);
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - stageStart;
+    result.stageSeconds.emplace_back(stage.name, elapsed.count());
+    if (!finished) {
+      Fwg::Utils::Logging::logLine("Isolated run stopped at ", stage.name);
+      return result;
+    }
+  }
+  if (random.owns_lock()) {
+    random.unlock();
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  result.seconds = elapsed.count();
+  result.finished = true;
+  result.summary = Snapshots::summarize(generator);
+
+  const auto &terrain = generator.terrainData;
+  const auto pixels = static_cast<std::size_t>(settings.width) *
+                      static_cast<std::size_t>(settings.height);
+  if (thumbnailWidth > 0 && terrain.detailedHeightMap.size() == pixels) {
+    result.thumbnail = thumbnail(terrain.detailedHeightMap, settings.width,
+                                 settings.height, thumbnailWidth);
+  }
+  if (terrain.landMask.size() == pixels) {
+    const auto land = std::count(terrain.landMask.begin(),
+                                 terrain.landMask.end(), true);
+    result.landShare = static_cast<double>(land) / pixels;
+    result.continents =
+        countContinents(terrain.landMask, settings.width, settings.height,
+                        std::max<std::size_t>(1, pixels / 200));
+  }
+  if (inspect) {
+    inspect(settings, generator);
+  }
+  return result;
+}
+
+} // namespace Fwg::UI::Stages
@@ -0,0 +1,39 @@
+#include "UI/JobGrid.h"
+#include <atomic>
+#include <thread>
+
+namespace Fwg::UI {
+
+static std::atomic<unsigned int> slotsTaken = 0;
+
+JobSlot JobSlot::take() {
+  static const unsigned int limit =
+      std::max(1u, std::thread::hardware_concurrency() / 2);
+  JobSlot slot;
+  auto taken = slotsTaken.load();
+  while (taken < limit) {
+    if (slotsTaken.compare_exchange_weak(taken, taken + 1)) {
+      slot.held = true;
+      break;
+    }
+  }
+  return slot;
+}
+
+JobSlot &JobSlot::operator=(JobSlot &&other) noexcept {
+  if (this != &other) {
+    if (held) {
+      slotsTaken--;
+    }
+    held = std::exchange(other.held, false);
+  }
+  return *this;
+}
+
+JobSlot::~JobSlot() {
+  if (held) {
+    slotsTaken--;
+  }
+}
+
+} // namespace Fwg::UI
@@ -0,0 +1,138 @@
+#include "UI/LayerThumbnails.h"
+#include "UI/GenerationStages.h"
+#include "UI/Hashing.h"
+#include "UI/JobGrid.h"
+#include <algorithm>
+
+namespace Fwg::UI {
+
+LayerThumbnails::~LayerThumbnails() {
+  for (auto &[key, thumbnail] : cache) {
+    Fwg::UI::Utils::freeTexture(&thumbnail.texture);
+  }
+}
+
+std::size_t LayerThumbnails::key(const Fwg::Cfg &cfg,
+                                 const LayerConfig &layer) {
+  // the map size sets the frequency scaling of the render
+  return Hashing::values(Hashing::layer(layer), cfg.width,
+                                 cfg.height, cfg.heightmapFrequencyModifier);
+}
+
+// The layer alone on a generator of its own, at thumbnail size. Noise
+// frequencies are per pixel, so they are raised by the reduction to show the
+// features the layer has on the full map.
+static Fwg::Gfx::Image render(Fwg::Cfg settings, LayerConfig layer,
+                              int group) {
+  const int factor =
+      std::max(1, std::max(settings.width, settings.height) /
+                      LayerThumbnails::resolution);
+  settings.width = std::max(1, settings.width / factor);
+  settings.height = std::max(1, settings.height / factor);
+  layer.fractalFrequency *= factor;
+  settings.shapeLayers.clear();
+  settings.landLayers.clear();
+  settings.seaLayers.clear();
+  (group == 0   ? settings.shapeLayers
+   : group == 1 ? settings.landLayers
+                : settings.seaLayers)
+      .push_back(layer);
+  settings.terrainConfig.heightmapPipeline.operations.clear();
+  Fwg::FastWorldGenerator generator;
+  {
+    std::lock_guard<std::mutex> random(Stages::randomMutex());
+    generator.configure(settings);
+  }
+  // the heightmap draws its noise from the layer seeds only
+  generator.genHeight();
+  const auto &terrain = generator.terrainData;
+  const auto &fields = group == 0   ? terrain.shapeLayers
+                       : group == 1 ? terrain.landLayers
+                                    : terrain.seaLayers;
+  if (fields.empty() || fields.front().size() !=
+                            static_cast<std::size_t>(settings.width) *
+                                settings.height) {
+    return Fwg::Gfx::Image();
+  }
+  return Fwg::Gfx::Image(settings.width, settings.height, 24, fields.front());
+}
+
+void LayerThumbnails::evict() {
+  while (cache.size() > capacity) {
+    auto oldest = std::min_element(
+        cache.begin(), cache.end(), [](const auto &a, const auto &b) {
+          return a.second.lastUse < b.second.lastUse;
+        });
+    Fwg::UI::Utils::freeTexture(&oldest->second.texture);
+    cache.erase(oldest);
+  }
+}
+
+void LayerThumbnails::collect(const Fwg::Cfg &cfg) {
+  frame++;
+  for (auto it = jobs.begin(); it != jobs.end();) {
+    if (it->second.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      ++it;
+      continue;
+    }
+    Thumbnail thumbnail{0, frame};
+    try {
+      const auto image = it->second.get();
+      int width = 0;
+      int height = 0;
+      if (image.initialised()) {
+        Fwg::UI::Utils::getResourceView(image, &thumbnail.texture, &width,
+                                        &height);
+      }
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Layer thumbnail failed: ",
+                                   e.what());
+    }
+    // failed renders are cached too, so they aren't retried every frame
+    cache[it->first] = thumbnail;
+    it = jobs.erase(it);
+  }
+
+  const auto now = Clock::now();
+  for (auto it = requests.begin(); it != requests.end();) {
+    auto &request = it->second;
+    // a layer that is being edited asks with a new key every frame
+    if (request.lastSeen + 1 < frame) {
+      it = requests.erase(it);
+      continue;
+    }
+    if (now - request.firstSeen < debounce) {
+      ++it;
+      continue;
+    }
+    auto slot = JobSlot::take();
+    if (!slot) {
+      break;
+    }
+    jobs[it->first] = runInSlot(
+        std::move(slot), [settings = cfg, layer = request.layer,
+                          group = request.group]() {
+          return render(settings, layer, group);
+        });
+    it = requests.erase(it);
+  }
+  evict();
+}
+
+GLuint LayerThumbnails::get(const Fwg::Cfg &cfg, const LayerConfig &layer,
+                            int group) {
+  const auto layerKey = key(cfg, layer);
+  if (auto it = cache.find(layerKey); it != cache.end()) {
+    it->second.lastUse = frame;
+    return it->second.texture;
+  }
+  if (!jobs.contains(layerKey)) {
+    auto [request, added] = requests.try_emplace(
+        layerKey, Request{layer, group, Clock::now(), frame});
+    request->second.lastSeen = frame;
+  }
+  return 0;
+}
+
+} // namespace Fwg::UI
@@ -0,0 +1,91 @@
+#include "UI/MappedFile.h"
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Fwg::UI {
+
+#if defined(_WIN32)
+bool MappedFile::open(const std::string &path) {
+  close();
+  HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  file = handle;
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+    close();
+    return false;
+  }
+  mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping) {
+    close();
+    return false;
+  }
+  view = static_cast<const char *>(
+      MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+  if (!view) {
+    close();
+    return false;
+  }
+  length = static_cast<std::size_t>(size.QuadPart);
+  return true;
+}
+
+void MappedFile::close() {
+  if (view) {
+    UnmapViewOfFile(view);
+  }
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  if (file) {
+    CloseHandle(file);
+  }
+  view = nullptr;
+  mapping = nullptr;
+  file = nullptr;
+  length = 0;
+}
+#else
+bool MappedFile::open(const std::string &path) {
+  close();
+  const int handle = ::open(path.c_str(), O_RDONLY);
+  if (handle < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(handle, &status) != 0 || status.st_size == 0) {
+    ::close(handle);
+    return false;
+  }
+  void *mapped =
+      mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+  // the mapping stays valid without the descriptor
+  ::close(handle);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+  view = static_cast<const char *>(mapped);
+  length = static_cast<std::size_t>(status.st_size);
+  return true;
+}
+
+void MappedFile::close() {
+  if (view) {
+    munmap(const_cast<char *>(view), length);
+  }
+  view = nullptr;
+  length = 0;
+}
+#endif
+
+} // namespace Fwg::UI
@@ -0,0 +1,38 @@
+#include "UI/MemoryLedger.h"
+
+namespace Fwg::UI::Memory {
+
+void Ledger::update(bool generatorBusy) {
+  for (std::size_t tries = 0; tries < groups.size(); tries++) {
+    auto &group = groups[next];
+    next = (next + 1) % groups.size();
+    if (generatorBusy && group.readsGenerator) {
+      continue;
+    }
+    group.items = group.measure();
+    group.bytes = 0;
+    for (const auto &item : group.items) {
+      group.bytes += item.bytes;
+    }
+    group.measured = true;
+    return;
+  }
+}
+
+std::size_t Ledger::total() const {
+  std::size_t bytes = 0;
+  for (const auto &group : groups) {
+    bytes += group.bytes;
+  }
+  return bytes;
+}
+
+std::size_t Ledger::generatorTotal() const {
+  std::size_t bytes = 0;
+  for (const auto &group : groups) {
+    bytes += group.readsGenerator ? group.bytes : 0;
+  }
+  return bytes;
+}
+
+} // namespace Fwg::UI::Memory
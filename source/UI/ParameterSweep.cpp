@@ -0,0 +1,159 @@
+#include "UI/ParameterSweep.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <type_traits>
+
+namespace Fwg::UI {
+
+template <auto member>
+static ParameterSweep::Parameter field(const char *name, double minimum,
+                                       double maximum,
+                                       Stages::StageId lastStage) {
+  return {name, minimum, maximum, lastStage,
+          [](const Fwg::Cfg &cfg) { return static_cast<double>(cfg.*member); },
+          [](Fwg::Cfg &cfg, double value) {
+            using Field = std::remove_cvref_t<decltype(cfg.*member)>;
+            cfg.*member = static_cast<Field>(value);
+          }};
+}
+
+const std::vector<ParameterSweep::Parameter> &ParameterSweep::parameters() {
+  using Stages::StageId;
+  static const std::vector<Parameter> parameters{
+      field<&Fwg::Cfg::landPercentage>("Target Land %", 0.0, 1.0,
+                                       StageId::LAND),
+      field<&Fwg::Cfg::heightmapFrequencyModifier>("Heightmap Frequency", 0.1,
+                                                   10.0, StageId::LAND),
+      field<&Fwg::Cfg::layerApplicationFactor>("Coastal Distance", 0.0, 1.0,
+                                               StageId::LAND),
+      field<&Fwg::Cfg::riverFactor>("River Amount", 0.0, 10.0,
+                                    StageId::RIVERS),
+      field<&Fwg::Cfg::landProvFactor>("Land Province Factor", 0.0, 10.0,
+                                       StageId::PROVINCES),
+      field<&Fwg::Cfg::seaProvFactor>("Sea Province Factor", 0.0, 10.0,
+                                      StageId::PROVINCES)};
+  return parameters;
+}
+
+double ParameterSweep::Axis::value(int step) const {
+  if (steps < 2) {
+    return from;
+  }
+  return from + (to - from) * step / (steps - 1);
+}
+
+void ParameterSweep::start(const Fwg::Cfg &cfg) {
+  cells.clear();
+  sweptX = x;
+  sweptY = twoParameters ? y : Axis{y.parameter, 0.0, 0.0, 1};
+  sweptTwo = twoParameters;
+  const auto &fields = parameters();
+  // the last stages reading the fields and everything they depend on
+  std::set<Stages::StageId> needed{fields[sweptX.parameter].lastStage};
+  if (sweptTwo) {
+    needed.insert(fields[sweptY.parameter].lastStage);
+  }
+  const auto all = Stages::worldStages();
+  for (std::size_t size = 0; size != needed.size();) {
+    size = needed.size();
+    for (const auto &stage : all) {
+      if (needed.contains(stage.id)) {
+        needed.insert(stage.dependencies.begin(), stage.dependencies.end());
+      }
+    }
+  }
+  stages.clear();
+  std::copy_if(all.begin(), all.end(), std::back_inserter(stages),
+               [&needed](const auto &stage) {
+                 return needed.contains(stage.id);
+               });
+
+  for (int row = 0; row < sweptY.steps; row++) {
+    for (int column = 0; column < sweptX.steps; column++) {
+      Cell cell;
+      cell.x = sweptX.value(column);
+      cell.y = sweptY.value(row);
+      // every cell keeps the current seed, so only the swept fields differ
+      auto settings = cfg;
+      settings.width = std::max(cfg.width / scale, 64);
+      settings.height = std::max(cfg.height / scale, 32);
+      settings.randomSeed = false;
+      fields[sweptX.parameter].set(settings, cell.x);
+      if (sweptTwo) {
+        fields[sweptY.parameter].set(settings, cell.y);
+      }
+      cell.work = [settings = std::move(settings), plan = stages]() {
+        // later stages show their own map instead of the heightmap
+        Fwg::Gfx::Image map;
+        auto result = Stages::runIsolated(
+            settings, plan, 200,
+            [&map, &plan](const Fwg::Cfg &,
+                          const Fwg::FastWorldGenerator &generator) {
+              if (plan.size() > 2 && plan.back().preview) {
+                map = plan.back().preview(generator);
+              }
+            });
+        if (map.initialised()) {
+          result.thumbnail = std::move(map);
+        }
+        return result;
+      };
+      cells.add(std::move(cell));
+    }
+  }
+}
+
+void ParameterSweep::update() {
+  cells.update([](const Cell &cell) {
+    std::ostringstream name;
+    name << "Sweep cell " << cell.x << ", " << cell.y;
+    return name.str();
+  });
+}
+
+void ParameterSweep::apply(const Cell &cell, Fwg::Cfg &cfg) const {
+  parameters()[sweptX.parameter].set(cfg, cell.x);
+  if (sweptTwo) {
+    parameters()[sweptY.parameter].set(cfg, cell.y);
+  }
+}
+
+bool ParameterSweep::writeCsv(const std::string &path) const {
+  std::ofstream file(path);
+  if (!file.good()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write sweep to ", path);
+    return false;
+  }
+  const auto &fields = parameters();
+  file << fields[sweptX.parameter].name;
+  if (sweptTwo) {
+    file << ',' << fields[sweptY.parameter].name;
+  }
+  file << ",finished,seconds,landShare,continents,rivers,provinces";
+  for (const auto &stage : stages) {
+    file << ',' << stage.name << " seconds";
+  }
+  file << '\n';
+  for (const auto &cell : cells.all()) {
+    file << cell.x;
+    if (sweptTwo) {
+      file << ',' << cell.y;
+    }
+    const auto &result = cell.result;
+    file << ',' << result.finished << ',' << result.seconds << ','
+         << result.landShare << ',' << result.continents << ','
+         << result.summary.riverCount << ',' << result.summary.provinceCount;
+    for (const auto &stage : result.stageSeconds) {
+      file << ',' << stage.second;
+    }
+    file << '\n';
+  }
+  Fwg::Utils::Logging::logLine("Wrote sweep of ", cells.all().size(),
+                               " worlds to ", path);
+  return true;
+}
+
+} // namespace Fwg::UI
@@ -0,0 +1,89 @@
+#include "UI/PipelinePreview.h"
+#include "UI/HeightmapCache.h"
+#include <algorithm>
+
+namespace Fwg::UI {
+
+// radii are given in pixels, shrink them with the map so the preview looks
+// like the full resolution result
+static void scaleParameter(Fwg::Terrain::HeightmapOperation &operation,
+                           const std::string &key, float fallback,
+                           int scale) {
+  const float value =
+      Fwg::Terrain::getParameter<float>(operation, key, fallback);
+  Fwg::Terrain::setParameter(operation, key, std::max(1.0f, value / scale));
+}
+
+void scaleOperations(std::vector<Fwg::Terrain::HeightmapOperation> &operations,
+                     int scale) {
+  using Fwg::Terrain::HeightmapOperationType;
+  for (auto &operation : operations) {
+    switch (operation.type) {
+    case HeightmapOperationType::GAUSSIAN_BLUR:
+    case HeightmapOperationType::GAUSSIAN_BLUR_WEIGHTS:
+      scaleParameter(operation, "radius", 2.0f, scale);
+      break;
+    case HeightmapOperationType::CRATER_GENERATION:
+      scaleParameter(operation, "minRadius", 5.0f, scale);
+      scaleParameter(operation, "maxRadius", 30.0f, scale);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+void PipelinePreview::start(const Fwg::Cfg &cfg) {
+  settings = std::make_unique<Fwg::Cfg>(cfg);
+  settings->width = std::max(cfg.width / scale, 16);
+  settings->height = std::max(cfg.height / scale, 16);
+  // the same operations as a full run, so the preview can't diverge from it
+  scaleOperations(settings->terrainConfig.heightmapPipeline.operations, scale);
+  jobRequest = latestRequest;
+  job = std::async(std::launch::async, [this, &reduced = *settings]() {
+    generator.configure(reduced);
+    generator.genHeight();
+    return Fwg::Gfx::Image(reduced.width, reduced.height, 24,
+                           generator.terrainData.detailedHeightMap);
+  });
+}
+
+bool PipelinePreview::update(const Fwg::Cfg &cfg, Fwg::Gfx::Image &frame,
+                             bool allowStart) {
+  const auto now = Clock::now();
+  const auto inputs = Stages::heightmapChain(cfg).back();
+  if (!primed) {
+    // the state the editor opened with is already on screen
+    primed = true;
+    lastInputs = inputs;
+  } else if (inputs != lastInputs) {
+    lastInputs = inputs;
+    lastEdit = now;
+    ++latestRequest;
+  }
+
+  bool fresh = false;
+  if (job.valid() &&
+      job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      auto image = job.get();
+      if (jobRequest == latestRequest && jobRequest != shownRequest) {
+        frame = std::move(image);
+        shownRequest = jobRequest;
+        fresh = true;
+      }
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Pipeline preview failed: ",
+                                   e.what());
+      shownRequest = jobRequest;
+    }
+  }
+
+  if (allowStart && !job.valid() && shownRequest != latestRequest &&
+      now - lastEdit >= debounce) {
+    start(cfg);
+  }
+  return fresh;
+}
+
+} // namespace Fwg::UI
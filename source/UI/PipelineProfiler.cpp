@@ -0,0 +1,189 @@
+#include "UI/PipelineProfiler.h"
+#include "UI/HeightmapCache.h"
+#include "UI/PipelinePreview.h"
+#include "UI/ProcessStats.h"
+#include <algorithm>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace Fwg::UI {
+using Clock = std::chrono::steady_clock;
+
+namespace {
+struct TimedSample {
+  double seconds;
+  ProcessSample sample;
+};
+
+struct Run {
+  double seconds;
+  ProcessSample baseline;
+  std::vector<TimedSample> samples;
+};
+} // namespace
+
+const OperationProfile *PipelineProfile::find(int index) const {
+  for (const auto &operation : operations) {
+    if (operation.index == index) {
+      return &operation;
+    }
+  }
+  return nullptr;
+}
+
+bool PipelineProfile::writeJson(const std::string &path) const {
+  namespace pt = boost::property_tree;
+  pt::ptree root;
+  root.put("width", width);
+  root.put("height", height);
+  root.put("baseSeconds", baseSeconds);
+  root.put("totalSeconds", totalSeconds);
+  pt::ptree list;
+  for (const auto &operation : operations) {
+    pt::ptree entry;
+    entry.put("index", operation.index);
+    entry.put("name", operation.name);
+    entry.put("type", static_cast<int>(operation.type));
+    entry.put("seconds", operation.seconds);
+    entry.put("processThreads", operation.processThreads);
+    entry.put("processPeakBytes", operation.processPeakBytes);
+    list.push_back({"", entry});
+  }
+  root.add_child("operations", list);
+  try {
+    pt::write_json(path, root);
+  } catch (const std::exception &e) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write pipeline profile to ",
+                                 path, ": ", e.what());
+    return false;
+  }
+  Fwg::Utils::Logging::logLine("Wrote pipeline profile to ", path);
+  return true;
+}
+
+PipelineProfile PipelineProfiler::measure(std::vector<int> indices) {
+  const auto operations = settings->terrainConfig.heightmapPipeline.operations;
+  std::vector<Run> runs;
+  // run k applies the first k enabled operations
+  for (std::size_t k = 0; k <= indices.size(); k++) {
+    auto &prefix = settings->terrainConfig.heightmapPipeline.operations;
+    prefix.clear();
+    for (std::size_t i = 0; i < k; i++) {
+      prefix.push_back(operations[indices[i]]);
+    }
+    Run fastest;
+    for (int repetition = 0; repetition < std::max(1, repetitions);
+         repetition++) {
+      generator.configure(*settings);
+
+      Run run;
+      std::mutex samplesMutex;
+      const auto start = Clock::now();
+      std::jthread sampler([&](std::stop_token stop) {
+        while (!stop.stop_requested()) {
+          const auto sample = sampleProcess();
+          const std::chrono::duration<double> elapsed = Clock::now() - start;
+          {
+            std::lock_guard<std::mutex> lock(samplesMutex);
+            run.samples.push_back({elapsed.count(), sample});
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+      });
+      // taken with the sampler running, so it doesn't count as a worker
+      run.baseline = sampleProcess();
+      generator.genHeight();
+      const std::chrono::duration<double> elapsed = Clock::now() - start;
+      sampler.request_stop();
+      sampler.join();
+      run.seconds = elapsed.count();
+      if (repetition == 0 || run.seconds < fastest.seconds) {
+        fastest = std::move(run);
+      }
+      runsDone++;
+    }
+    runs.push_back(std::move(fastest));
+  }
+
+  PipelineProfile profile;
+  profile.width = settings->width;
+  profile.height = settings->height;
+  profile.baseSeconds = runs.front().seconds;
+  profile.totalSeconds = runs.back().seconds;
+  for (std::size_t k = 1; k < runs.size(); k++) {
+    const auto &run = runs[k];
+    const auto &operation = operations[indices[k - 1]];
+    OperationProfile entry{indices[k - 1], operation.name, operation.type,
+                           std::max(0.0, run.seconds - runs[k - 1].seconds),
+                           1, 0};
+    // samples after the point where the shorter prefix finished belong to
+    // the added operation
+    for (const auto &timed : run.samples) {
+      if (timed.seconds < runs[k - 1].seconds) {
+        continue;
+      }
+      entry.processThreads =
+          std::max(entry.processThreads,
+                   timed.sample.threads - run.baseline.threads + 1);
+      if (timed.sample.residentBytes > run.baseline.residentBytes) {
+        entry.processPeakBytes =
+            std::max(entry.processPeakBytes,
+                     timed.sample.residentBytes - run.baseline.residentBytes);
+      }
+    }
+    profile.operations.push_back(entry);
+  }
+  return profile;
+}
+
+void PipelineProfiler::start(const Fwg::Cfg &cfg) {
+  if (running()) {
+    return;
+  }
+  settings = std::make_unique<Fwg::Cfg>(cfg);
+  settings->width = std::max(cfg.width / scale, 16);
+  settings->height = std::max(cfg.height / scale, 16);
+  scaleOperations(settings->terrainConfig.heightmapPipeline.operations, scale);
+  std::vector<int> indices;
+  const auto &operations = cfg.terrainConfig.heightmapPipeline.operations;
+  for (int i = 0; i < static_cast<int>(operations.size()); i++) {
+    if (operations[i].enabled) {
+      indices.push_back(i);
+    }
+  }
+  runsDone = 0;
+  runsTotal = (static_cast<int>(indices.size()) + 1) * std::max(1, repetitions);
+  const auto inputs = Stages::heightmapChain(cfg).back();
+  job = std::async(std::launch::async, [this, indices, inputs]() {
+    auto profile = measure(indices);
+    profile.inputs = inputs;
+    return profile;
+  });
+}
+
+void PipelineProfiler::poll() {
+  if (!job.valid() ||
+      job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+  try {
+    last = job.get();
+    hasProfile = true;
+  } catch (const std::exception &e) {
+    Fwg::Utils::Logging::logLine("ERROR: Pipeline profiling failed: ",
+                                 e.what());
+  }
+}
+
+float PipelineProfiler::progress() const {
+  return runsTotal ? static_cast<float>(runsDone) / runsTotal : 0.0f;
+}
+
+const PipelineProfile *PipelineProfiler::profile() const {
+  return hasProfile ? &last : nullptr;
+}
+
+} // namespace Fwg::UI
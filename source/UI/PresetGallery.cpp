@@ -0,0 +1,123 @@
+#include "UI/PresetGallery.h"
+#include "UI/ConfigFields.h"
+#include "UI/HeightmapCache.h"
+#include "UI/Hashing.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <type_traits>
+
+namespace Fwg::UI {
+using HeightField = std::remove_cvref_t<
+    decltype(std::declval<Fwg::Terrain::TerrainData &>().detailedHeightMap)>;
+
+static bool readCached(const std::string &file, HeightField &heights) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    return false;
+  }
+  heights.resize(static_cast<std::size_t>(PresetGallery::width) *
+                 PresetGallery::height);
+  in.read(reinterpret_cast<char *>(heights.data()),
+          heights.size() * sizeof(HeightField::value_type));
+  return static_cast<bool>(in);
+}
+
+static void writeCached(const std::string &file, const HeightField &heights) {
+  std::ofstream out(file, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(heights.data()),
+            heights.size() * sizeof(HeightField::value_type));
+}
+
+// settings hold the current config with the preset applied
+static Fwg::Gfx::Image render(const Fwg::Cfg &settings, std::size_t inputs,
+                              const std::string &cacheFolder) {
+  std::ostringstream name;
+  name << std::hex << inputs << ".bin";
+  const auto file = cacheFolder + name.str();
+
+  HeightField heights;
+  if (!readCached(file, heights)) {
+    Fwg::FastWorldGenerator generator;
+    generator.configure(settings);
+    generator.genHeight();
+    heights = generator.terrainData.detailedHeightMap;
+    if (heights.size() != static_cast<std::size_t>(PresetGallery::width) *
+                              PresetGallery::height) {
+      return Fwg::Gfx::Image();
+    }
+    writeCached(file, heights);
+  }
+  return Fwg::Gfx::Image(PresetGallery::width, PresetGallery::height, 24,
+                         heights);
+}
+
+PresetGallery::~PresetGallery() {
+  for (auto &[path, entry] : entries) {
+    Fwg::UI::Utils::freeTexture(&entry.texture);
+  }
+}
+
+void PresetGallery::update(const Fwg::Cfg &cfg,
+                           const HeightmapPresets &presets) {
+  const auto catalog = presets.catalog();
+  if (!catalog) {
+    return;
+  }
+  if (cacheFolder.empty()) {
+    cacheFolder = cfg.workingDirectory + "cache/presets/";
+    std::error_code error;
+    std::filesystem::create_directories(cacheFolder, error);
+  }
+  // merging every preset is only redone when the config or catalog changed
+  const auto current =
+      Hashing::values(Stages::heightmapChain(cfg).back(), catalog->version);
+  const bool changed = current != inputs;
+  inputs = current;
+  for (const auto &[path, fields] : catalog->presets) {
+    auto &entry = entries[path];
+    if (entry.job.valid() && entry.job.wait_for(std::chrono::seconds(0)) ==
+                                 std::future_status::ready) {
+      try {
+        const auto image = entry.job.get();
+        Fwg::UI::Utils::freeTexture(&entry.texture);
+        int width = 0;
+        int height = 0;
+        if (image.initialised()) {
+          Fwg::UI::Utils::getResourceView(image, &entry.texture, &width,
+                                          &height);
+        }
+      } catch (const std::exception &e) {
+        Fwg::Utils::Logging::logLine("ERROR: Preset thumbnail for ", path,
+                                     " failed: ", e.what());
+      }
+    }
+    if (changed || !entry.settings) {
+      auto settings = std::make_shared<Fwg::Cfg>(cfg);
+      ConfigFields::apply(fields, *settings);
+      settings->width = PresetGallery::width;
+      settings->height = PresetGallery::height;
+      settings->landInputMode = Fwg::Terrain::InputMode::HEIGHTMAP;
+      entry.inputs = Stages::heightmapChain(*settings).back();
+      entry.settings = std::move(settings);
+    }
+    if (entry.request == entry.inputs || entry.job.valid()) {
+      continue;
+    }
+    if (auto slot = JobSlot::take()) {
+      entry.request = entry.inputs;
+      entry.job = runInSlot(std::move(slot), [settings = entry.settings,
+                                              request = entry.request,
+                                              folder = cacheFolder]() {
+        return render(*settings, request, folder);
+      });
+    }
+  }
+}
+
+GLuint PresetGallery::texture(const std::string &path) const {
+  const auto it = entries.find(path);
+  return it != entries.end() ? it->second.texture : 0;
+}
+
+} // namespace Fwg::UI
@@ -0,0 +1,57 @@
+#include "UI/ProcessStats.h"
+#if defined(_WIN32)
+#include <windows.h>
+// windows.h has to come first
+#include <psapi.h>
+#include <tlhelp32.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <string>
+#endif
+
+namespace Fwg::UI {
+
+#if defined(_WIN32)
+ProcessSample sampleProcess() {
+  ProcessSample sample;
+  PROCESS_MEMORY_COUNTERS counters{};
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    sample.residentBytes = counters.WorkingSetSize;
+  }
+  const DWORD processId = GetCurrentProcessId();
+  HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+  if (snapshot != INVALID_HANDLE_VALUE) {
+    THREADENTRY32 entry{};
+    entry.dwSize = sizeof(entry);
+    for (BOOL more = Thread32First(snapshot, &entry); more;
+         more = Thread32Next(snapshot, &entry)) {
+      if (entry.th32OwnerProcessID == processId) {
+        sample.threads++;
+      }
+    }
+    CloseHandle(snapshot);
+  }
+  return sample;
+}
+#elif defined(__linux__)
+ProcessSample sampleProcess() {
+  ProcessSample sample;
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmRSS:") {
+      // reported in kB
+      std::size_t kilobytes = 0;
+      status >> kilobytes;
+      sample.residentBytes = kilobytes * 1024;
+    } else if (key == "Threads:") {
+      status >> sample.threads;
+    }
+  }
+  return sample;
+}
+#else
+ProcessSample sampleProcess() { return {}; }
+#endif
+
+} // namespace Fwg::UI
@@ -0,0 +1,164 @@
+#include "UI/Progress.h"
+#include <algorithm>
+#include <fstream>
+
+namespace Fwg::UI::Progress {
+
+std::string ProgressTracker::historyKey(const std::string &stage,
+                                        long long resolution) {
+  return stage + "|" + std::to_string(resolution);
+}
+
+double ProgressTracker::lookup(const std::string &stage,
+                               long long resolution) const {
+  auto it = history.find(historyKey(stage, resolution));
+  return it != history.end() ? it->second : -1.0;
+}
+
+double ProgressTracker::expectedSeconds(const std::string &stage,
+                                        long long resolution) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return lookup(stage, resolution);
+}
+
+int ProgressTracker::beginJob(const std::string &name,
+                              const std::vector<std::string> &stages,
+                              long long resolution) {
+  std::lock_guard<std::mutex> lock(mutex);
+  const int id = nextJobId++;
+  auto &job = jobs[id];
+  job.name = name;
+  job.stages = stages;
+  job.resolution = resolution;
+  job.finished.assign(stages.size(), false);
+  job.jobStart = Clock::now();
+  return id;
+}
+
+void ProgressTracker::beginStage(int jobId, int stageIndex) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = jobs.find(jobId);
+  if (it != jobs.end() && stageIndex >= 0 &&
+      stageIndex < (int)it->second.stages.size()) {
+    it->second.running[stageIndex] = Clock::now();
+  }
+}
+
+void ProgressTracker::endStage(int jobId, int stageIndex) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = jobs.find(jobId);
+  if (it == jobs.end()) {
+    return;
+  }
+  auto &job = it->second;
+  const auto stage = job.running.find(stageIndex);
+  if (stage == job.running.end()) {
+    return;
+  }
+  const double seconds =
+      std::chrono::duration<double>(Clock::now() - stage->second).count();
+  job.running.erase(stage);
+  job.finished[stageIndex] = true;
+  job.finishedCount++;
+  auto &entry = history[historyKey(job.stages[stageIndex], job.resolution)];
+  // smooth over runs, but let the first run set the value directly
+  entry = entry > 0.0 ? 0.7 * entry + 0.3 * seconds : seconds;
+}
+
+void ProgressTracker::endJob(int jobId) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    jobs.erase(jobId);
+  }
+  saveHistory();
+}
+
+std::vector<JobStatus> ProgressTracker::status() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto now = Clock::now();
+  std::vector<JobStatus> result;
+  for (const auto &[id, job] : jobs) {
+    JobStatus status{id, job.name, "", job.finishedCount,
+                     (int)job.stages.size(), 0.0f, 0.0, -1.0};
+    status.elapsedSeconds =
+        std::chrono::duration<double>(now - job.jobStart).count();
+    if (job.running.empty() || job.stages.empty()) {
+      result.push_back(status);
+      continue;
+    }
+
+    double progress = job.finishedCount;
+    // the overlapping stages end with the longest one of them
+    double eta = 0.0;
+    bool known = true;
+    for (const auto &[index, start] : job.running) {
+      const auto &name = job.stages[index];
+      status.stageName += (status.stageName.empty() ? "" : ", ") + name;
+      const double stageElapsed =
+          std::chrono::duration<double>(now - start).count();
+      const double stageExpected = lookup(name, job.resolution);
+      // without history we can only count finished stages
+      if (stageExpected > 0.0) {
+        progress += std::min(0.95, stageElapsed / stageExpected);
+      }
+      known = known && stageExpected >= 0.0;
+      eta = std::max(eta, stageExpected - stageElapsed);
+    }
+    status.fraction = static_cast<float>(
+        progress / static_cast<double>(job.stages.size()));
+
+    for (size_t i = 0; i < job.stages.size() && known; i++) {
+      if (job.finished[i] || job.running.contains((int)i)) {
+        continue;
+      }
+      const double expected = lookup(job.stages[i], job.resolution);
+      known = expected >= 0.0;
+      eta += expected;
+    }
+    status.etaSeconds = known ? eta : -1.0;
+    result.push_back(status);
+  }
+  return result;
+}
+
+void ProgressTracker::setSummary(const std::string &summary) {
+  std::lock_guard<std::mutex> lock(mutex);
+  lastSummary = summary;
+}
+
+std::string ProgressTracker::summary() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return lastSummary;
+}
+
+void ProgressTracker::loadHistory(const std::string &path) {
+  std::lock_guard<std::mutex> lock(mutex);
+  historyFile = path;
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    // stage|resolution|seconds
+    const auto last = line.find_last_of('|');
+    if (last == std::string::npos) {
+      continue;
+    }
+    try {
+      history[line.substr(0, last)] = std::stod(line.substr(last + 1));
+    } catch (std::exception &) {
+      continue;
+    }
+  }
+}
+
+void ProgressTracker::saveHistory() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (historyFile.empty()) {
+    return;
+  }
+  std::ofstream file(historyFile);
+  for (const auto &[key, seconds] : history) {
+    file << key << "|" << seconds << "\n";
+  }
+}
+
+} // namespace Fwg::UI::Progress
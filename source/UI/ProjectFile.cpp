@@ -0,0 +1,465 @@
+#include "UI/ProjectFile.h"
+#include "UI/ColdLayers.h"
+#include "UI/ConfigFields.h"
+#include <algorithm>
+#include <boost/property_tree/json_parser.hpp>
+#include <optional>
+#include <sstream>
+
+namespace Fwg::UI::Project {
+using Stages::StageId;
+
+static constexpr char magic[8] = {'F', 'W', 'G', 'P', 'R', 'O', 'J', '\0'};
+static constexpr std::uint32_t formatVersion = 2;
+
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t chunkCount;
+  std::uint64_t tocOffset;
+};
+
+bool Writer::open(const std::string &path) {
+  this->path = path;
+  toc.clear();
+  file.open(path, std::ios::binary | std::ios::trunc);
+  if (!file.good()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write project ", path);
+    return false;
+  }
+  // rewritten with the table offset once all chunks are written
+  const Header header{};
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  return file.good();
+}
+
+void Writer::add(const std::string &name, const void *data, std::size_t bytes,
+                 std::size_t elementSize) {
+  // chunks start at 8 byte boundaries
+  static const char padding[8] = {};
+  const auto position = static_cast<std::uint64_t>(file.tellp());
+  file.write(padding, (8 - position % 8) % 8);
+  toc.push_back({name,
+                 {static_cast<std::uint64_t>(file.tellp()), bytes,
+                  static_cast<std::uint32_t>(elementSize)}});
+  file.write(static_cast<const char *>(data), bytes);
+}
+
+bool Writer::finish() {
+  Header header{};
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = formatVersion;
+  header.chunkCount = static_cast<std::uint32_t>(toc.size());
+  header.tocOffset = static_cast<std::uint64_t>(file.tellp());
+  auto write = [this](const auto &value) {
+    file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  };
+  for (const auto &[name, chunk] : toc) {
+    write(static_cast<std::uint32_t>(name.size()));
+    file.write(name.data(), name.size());
+    write(chunk.offset);
+    write(chunk.bytes);
+    write(chunk.elementSize);
+  }
+  file.seekp(0);
+  write(header);
+  file.close();
+  if (file.fail()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write project ", path);
+    return false;
+  }
+  return true;
+}
+
+bool Reader::open(const std::string &path) {
+  toc.clear();
+  if (!file.open(path)) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't open project ", path);
+    return false;
+  }
+  std::size_t cursor = 0;
+  auto take = [this, &cursor](void *value, std::size_t bytes) {
+    if (cursor + bytes > file.size()) {
+      return false;
+    }
+    std::memcpy(value, file.data() + cursor, bytes);
+    cursor += bytes;
+    return true;
+  };
+  Header header;
+  if (!take(&header, sizeof(header)) ||
+      std::memcmp(header.magic, magic, sizeof(magic)) != 0 ||
+      header.version != formatVersion) {
+    Fwg::Utils::Logging::logLine("ERROR: ", path,
+                                 " is no project of this version");
+    return false;
+  }
+  cursor = header.tocOffset;
+  for (std::uint32_t i = 0; i < header.chunkCount; i++) {
+    std::uint32_t length = 0;
+    Chunk chunk;
+    std::string name;
+    bool valid = take(&length, sizeof(length)) &&
+                 cursor + length <= file.size();
+    if (valid) {
+      name.assign(file.data() + cursor, length);
+      cursor += length;
+      valid = take(&chunk.offset, sizeof(chunk.offset)) &&
+              take(&chunk.bytes, sizeof(chunk.bytes)) &&
+              take(&chunk.elementSize, sizeof(chunk.elementSize)) &&
+              chunk.elementSize > 0 && chunk.offset <= file.size() &&
+              chunk.bytes <= file.size() - chunk.offset;
+    }
+    if (!valid) {
+      Fwg::Utils::Logging::logLine("ERROR: Damaged table of contents in ",
+                                   path);
+      toc.clear();
+      return false;
+    }
+    toc[name] = chunk;
+  }
+  return true;
+}
+
+template <typename T> struct IsFlatVector : std::false_type {};
+template <typename T, typename A>
+struct IsFlatVector<std::vector<T, A>>
+    : std::bool_constant<std::is_trivially_copyable_v<T> &&
+                         !std::is_same_v<T, bool>> {};
+template <typename T> struct IsNestedVector : std::false_type {};
+template <typename T, typename A>
+struct IsNestedVector<std::vector<T, A>> : IsFlatVector<T> {};
+
+// pixels as rgb triples, which doesn't depend on the layout of Colour
+static std::vector<std::uint8_t>
+rgb(const std::vector<Fwg::Gfx::Colour> &pixels) {
+  std::vector<std::uint8_t> bytes(pixels.size() * 3);
+  for (std::size_t i = 0; i < pixels.size(); i++) {
+    bytes[i * 3] = pixels[i].getRed();
+    bytes[i * 3 + 1] = pixels[i].getGreen();
+    bytes[i * 3 + 2] = pixels[i].getBlue();
+  }
+  return bytes;
+}
+
+// false if fields of this type can't be stored, empty fields are skipped so
+// their stages stay missing after loading
+template <typename T>
+static bool store(Writer &writer, const std::string &name, const T &field) {
+  if constexpr (std::is_same_v<T, Fwg::Gfx::Image>) {
+    if (field.initialised()) {
+      writer.add(name + ".size",
+                 std::vector<std::int32_t>{field.width(), field.height()});
+      writer.add(name, rgb(field.imageData));
+    }
+  } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    if (!field.empty()) {
+      writer.add(name, std::vector<std::uint8_t>(field.begin(), field.end()));
+    }
+  } else if constexpr (IsFlatVector<T>::value) {
+    if (!field.empty()) {
+      writer.add(name, field);
+    }
+  } else if constexpr (IsNestedVector<T>::value) {
+    if (field.empty()) {
+      return true;
+    }
+    // one chunk per inner vector, so nothing is concatenated in memory
+    writer.add(name + ".count", std::vector<std::uint64_t>{field.size()});
+    for (std::size_t i = 0; i < field.size(); i++) {
+      writer.add(name + "." + std::to_string(i), field[i]);
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// false if the chunk is missing or fields of this type can't be stored
+template <typename T>
+static bool load(const Reader &reader, const std::string &name, T &field) {
+  if constexpr (std::is_same_v<T, Fwg::Gfx::Image>) {
+    std::vector<std::int32_t> size;
+    std::vector<std::uint8_t> bytes;
+    if (!reader.read(name + ".size", size) || size.size() != 2 ||
+        !reader.read(name, bytes) ||
+        bytes.size() != static_cast<std::size_t>(size[0]) * size[1] * 3) {
+      return false;
+    }
+    Fwg::Gfx::Image image(size[0], size[1], 24);
+    for (std::size_t i = 0; i < image.imageData.size(); i++) {
+      image.imageData[i] =
+          Fwg::Gfx::Colour(bytes[i * 3], bytes[i * 3 + 1], bytes[i * 3 + 2]);
+    }
+    field = std::move(image);
+    return true;
+  } else if constexpr (std::is_same_v<T, std::vector<bool>>) {
+    std::vector<std::uint8_t> bytes;
+    if (!reader.read(name, bytes)) {
+      return false;
+    }
+    field.assign(bytes.begin(), bytes.end());
+    return true;
+  } else if constexpr (IsFlatVector<T>::value) {
+    return reader.read(name, field);
+  } else if constexpr (IsNestedVector<T>::value) {
+    std::vector<std::uint64_t> count;
+    if (!reader.read(name + ".count", count) || count.size() != 1) {
+      return false;
+    }
+    T values(count.front());
+    for (std::size_t i = 0; i < values.size(); i++) {
+      if (!reader.read(name + "." + std::to_string(i), values[i])) {
+        return false;
+      }
+    }
+    field = std::move(values);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+// every stored generator field, with its part and the stage writing it.
+// The noise layers are stored apart, lean memory may hold them.
+template <typename Generator, typename Visit>
+static void forEachField(Generator &fwg, Visit &&visit) {
+  auto &terrain = fwg.terrainData;
+  auto &climate = fwg.climateData;
+  visit(Part::TERRAIN, StageId::HEIGHTMAP, "terrain.heightmap",
+        terrain.detailedHeightMap);
+  visit(Part::TERRAIN, StageId::LAND, "terrain.landMask", terrain.landMask);
+  visit(Part::TERRAIN, StageId::LAND, "terrain.landforms",
+        terrain.landFormIds);
+  visit(Part::TERRAIN, StageId::NORMALMAP, "terrain.sobel", terrain.sobelData);
+  visit(Part::CLIMATE, StageId::TEMPERATURE, "climate.temperatures",
+        climate.averageTemperatures);
+  visit(Part::CLIMATE, StageId::HUMIDITY, "climate.humidities",
+        climate.humidities);
+  visit(Part::CLIMATE, StageId::RIVERS, "climate.rivers", climate.rivers);
+  visit(Part::CLIMATE, StageId::CLIMATE, "climate.chances",
+        climate.climateChances);
+  visit(Part::CLIMATE, StageId::HABITABILITY, "climate.habitabilities",
+        climate.habitabilities);
+  visit(Part::CLIMATE, StageId::WORLDMAP, "images.worldMap", fwg.worldMap);
+  // the area objects aren't stored, so their stages stay missing
+  const std::optional<StageId> none;
+  visit(Part::AREAS, none, "images.segmentMap", fwg.segmentMap);
+  visit(Part::AREAS, none, "images.provinceMap", fwg.provinceMap);
+  visit(Part::AREAS, none, "images.errorMap", fwg.errorMap);
+}
+
+static const char *inputName(Part part) {
+  return part == Part::LAND_INPUT ? "input.land" : "input.climate";
+}
+
+static constexpr const char *layerNames[3] = {
+    "terrain.shapeLayers", "terrain.landLayers", "terrain.seaLayers"};
+
+template <typename Generator>
+static auto &layerGroup(Generator &fwg, int group) {
+  auto &terrain = fwg.terrainData;
+  return group == 0   ? terrain.shapeLayers
+         : group == 1 ? terrain.landLayers
+                      : terrain.seaLayers;
+}
+
+// The layers of the generator, or the ones lean memory holds, decoded one at
+// a time. The count is written for empty groups too, so a missing group
+// tells the heightmap apart from one without layers.
+static bool storeLayers(Writer &writer, const Fwg::FastWorldGenerator &fwg,
+                        int group) {
+  const std::string name = layerNames[group];
+  const auto &layers = layerGroup(fwg, group);
+  const auto &coldLayers = Stages::ColdLayers::shared();
+  if (!layers.empty() || !coldLayers.frozen()) {
+    writer.add(name + ".count", std::vector<std::uint64_t>{layers.size()});
+    for (std::size_t i = 0; i < layers.size(); i++) {
+      writer.add(name + "." + std::to_string(i), layers[i]);
+    }
+    return true;
+  }
+  const auto count = coldLayers.heldLayers(group);
+  Stages::LayerField layer;
+  for (std::size_t i = 0; i < count; i++) {
+    if (!coldLayers.peek(group, i, layer)) {
+      return false;
+    }
+    writer.add(name + "." + std::to_string(i), layer);
+  }
+  // written last, so a group that failed halfway can't be loaded
+  writer.add(name + ".count", std::vector<std::uint64_t>{count});
+  return true;
+}
+
+// the Cfg as the json of the config files
+static std::string settings(const Fwg::Cfg &cfg) {
+  std::ostringstream text;
+  boost::property_tree::write_json(text, ConfigFields::tree(cfg));
+  return text.str();
+}
+
+static bool applySettings(const std::string &text, Fwg::Cfg &cfg) {
+  boost::property_tree::ptree tree;
+  try {
+    std::istringstream json(text);
+    boost::property_tree::read_json(json, tree);
+  } catch (const boost::property_tree::json_parser_error &e) {
+    Fwg::Utils::Logging::logLine("ERROR: Invalid project settings: ",
+                                 e.what());
+    return false;
+  }
+  // invalid fields are logged and keep their value
+  ConfigFields::apply(tree, cfg);
+  // the next run seeds the random generator from it, see Stages::reseed
+  cfg.randomSeed = false;
+  return true;
+}
+
+bool save(const std::string &path, const Fwg::Cfg &cfg,
+          const Fwg::FastWorldGenerator &fwg, const Input &landInput,
+          const Input &climateInput) {
+  Writer writer;
+  if (!writer.open(path)) {
+    return false;
+  }
+  const auto text = settings(cfg);
+  writer.add("settings", std::vector<char>(text.begin(), text.end()));
+  forEachField(fwg, [&writer](Part, std::optional<StageId>, const char *name,
+                              const auto &field) {
+    if (!store(writer, name, field)) {
+      Fwg::Utils::Logging::logLine("Project: ", name,
+                                   " can't be stored, its stage has to run "
+                                   "again after opening");
+    }
+  });
+  for (int group = 0; group < 3; group++) {
+    if (!storeLayers(writer, fwg, group)) {
+      Fwg::Utils::Logging::logLine("ERROR: Couldn't restore frozen ",
+                                   layerNames[group],
+                                   ", the heightmap has to run again after "
+                                   "opening");
+    }
+  }
+  for (const auto part : {Part::LAND_INPUT, Part::CLIMATE_INPUT}) {
+    const auto &input = part == Part::LAND_INPUT ? landInput : climateInput;
+    const std::string name = inputName(part);
+    store(writer, name, input.image);
+    std::vector<Fwg::Gfx::Colour> colours;
+    for (const auto &[in, out] : input.mapping) {
+      colours.push_back(in);
+      colours.push_back(out);
+    }
+    writer.add(name + ".mapping", rgb(colours));
+  }
+  if (!writer.finish()) {
+    return false;
+  }
+  Fwg::Utils::Logging::logLine("Saved project to ", path);
+  return true;
+}
+
+bool Session::open(const std::string &path, Fwg::Cfg &cfg) {
+  auto next = std::make_shared<Reader>();
+  if (!next->open(path)) {
+    return false;
+  }
+  std::vector<char> text;
+  if (!next->read("settings", text)) {
+    Fwg::Utils::Logging::logLine("ERROR: Project ", path, " has no settings");
+    return false;
+  }
+  if (!applySettings(std::string(text.begin(), text.end()), cfg)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  reader = std::move(next);
+  pendingParts = {Part::TERRAIN, Part::CLIMATE, Part::AREAS,
+                  Part::LAND_INPUT, Part::CLIMATE_INPUT};
+  return true;
+}
+
+void Session::taken(Part part) {
+  std::lock_guard<std::mutex> lock(mutex);
+  pendingParts.erase(part);
+  if (pendingParts.empty()) {
+    reader.reset();
+  }
+}
+
+bool Session::pending(Part part) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return pendingParts.contains(part);
+}
+
+std::vector<Part> Session::generatorParts(Part preferred) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::vector<Part> parts;
+  for (const auto part : {preferred, Part::TERRAIN, Part::CLIMATE,
+                          Part::AREAS}) {
+    if (part <= Part::AREAS && pendingParts.contains(part) &&
+        std::find(parts.begin(), parts.end(), part) == parts.end()) {
+      parts.push_back(part);
+    }
+  }
+  return parts;
+}
+
+bool Session::materialise(Part part, Fwg::FastWorldGenerator &fwg,
+                          Stages::StalenessTracker &staleness) {
+  std::shared_ptr<const Reader> file;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pendingParts.contains(part)) {
+      return false;
+    }
+    file = reader;
+  }
+  std::set<StageId> loaded;
+  forEachField(fwg, [&](Part fieldPart, std::optional<StageId> stage,
+                        const char *name, auto &field) {
+    if (fieldPart == part && load(*file, name, field) && stage) {
+      loaded.insert(*stage);
+    }
+  });
+  if (part == Part::TERRAIN) {
+    // the land stage reads the layers, without them the heightmap has to run
+    bool layersLoaded = true;
+    for (int group = 0; group < 3; group++) {
+      layersLoaded &= load(*file, layerNames[group], layerGroup(fwg, group));
+    }
+    if (!layersLoaded) {
+      loaded.erase(StageId::HEIGHTMAP);
+    }
+  }
+  for (const auto stage : loaded) {
+    staleness.markLoaded(stage);
+  }
+  taken(part);
+  return true;
+}
+
+bool Session::input(Part part, Fwg::Gfx::Image &image, Mapping &mapping) {
+  std::shared_ptr<const Reader> file;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pendingParts.contains(part)) {
+      return false;
+    }
+    file = reader;
+  }
+  const std::string name = inputName(part);
+  const bool found = load(*file, name, image);
+  std::vector<std::uint8_t> bytes;
+  if (found && file->read(name + ".mapping", bytes)) {
+    for (std::size_t i = 0; i + 6 <= bytes.size(); i += 6) {
+      mapping.emplace_back(
+          Fwg::Gfx::Colour(bytes[i], bytes[i + 1], bytes[i + 2]),
+          Fwg::Gfx::Colour(bytes[i + 3], bytes[i + 4], bytes[i + 5]));
+    }
+  }
+  taken(part);
+  return found;
+}
+
+} // namespace Fwg::UI::Project
@@ -0,0 +1,38 @@
+#include "UI/SeedExplorer.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+
+namespace Fwg::UI {
+
+void SeedExplorer::start(const Fwg::Cfg &cfg) {
+  cells.clear();
+  // an engine of its own, a job of the UI may be drawing from the shared one
+  static std::mt19937 engine(std::random_device{}());
+  std::uniform_int_distribution<int> anySeed(
+      0, std::numeric_limits<int>::max());
+  for (int i = 0; i < count; i++) {
+    Cell cell;
+    cell.seed = randomSeeds ? anySeed(engine) : cfg.mapSeed + 1 + i;
+    auto settings = cfg;
+    settings.width = std::max(cfg.width / scale, 64);
+    settings.height = std::max(cfg.height / scale, 32);
+    settings.mapSeed = cell.seed;
+    // the job seeds the shared random generator, see runIsolated
+    cell.work = [settings = std::move(settings)]() {
+      return Stages::runIsolated(settings,
+                                 {Stages::get(Stages::StageId::HEIGHTMAP),
+                                  Stages::get(Stages::StageId::LAND)},
+                                 200);
+    };
+    cells.add(std::move(cell));
+  }
+}
+
+void SeedExplorer::update() {
+  cells.update([](const Cell &cell) {
+    return "Exploring seed " + std::to_string(cell.seed);
+  });
+}
+
+} // namespace Fwg::UI
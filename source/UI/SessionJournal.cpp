@@ -0,0 +1,404 @@
+#include "UI/SessionJournal.h"
+#include "UI/ClimateUI.h"
+#include "UI/ConfigFields.h"
+#include "UI/landUI.h"
+#include <algorithm>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+namespace Fwg::UI::Journal {
+
+static const char *actionNames[] = {"job",  "load",     "field",
+                                    "seed", "classify", "analyse"};
+
+static std::vector<std::string> split(const std::string &text, char separator) {
+  std::vector<std::string> parts;
+  std::stringstream stream(text);
+  std::string part;
+  while (std::getline(stream, part, separator)) {
+    parts.push_back(part);
+  }
+  return parts;
+}
+
+static std::string colourText(const Fwg::Gfx::Colour &colour) {
+  return std::to_string(colour.getRed()) + "," +
+         std::to_string(colour.getGreen()) + "," +
+         std::to_string(colour.getBlue());
+}
+
+static Fwg::Gfx::Colour parseColour(const std::string &text) {
+  const auto parts = split(text, ',');
+  if (parts.size() != 3) {
+    throw std::invalid_argument("Invalid colour " + text);
+  }
+  return Fwg::Gfx::Colour(static_cast<unsigned char>(std::stoi(parts[0])),
+                          static_cast<unsigned char>(std::stoi(parts[1])),
+                          static_cast<unsigned char>(std::stoi(parts[2])));
+}
+
+void Recorder::begin(const Fwg::Cfg &cfg) {
+  std::lock_guard<std::mutex> lock(mutex);
+  entries.clear();
+  start = Clock::now();
+  active = true;
+  // no known fields make the first watch record every field
+  fields.clear();
+  seed = cfg.mapSeed;
+  entries.push_back({0.0, Action::SEED, std::to_string(seed)});
+  watchLocked(cfg);
+}
+
+void Recorder::end() {
+  std::lock_guard<std::mutex> lock(mutex);
+  active = false;
+}
+
+bool Recorder::recording() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return active;
+}
+
+std::size_t Recorder::size() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+void Recorder::record(Action action, const std::string &detail) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!active) {
+    return;
+  }
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  entries.push_back({elapsed.count(), action, detail});
+}
+
+void Recorder::recordJob(const std::string &jobName,
+                         const std::vector<Stages::Stage> &stages,
+                         bool concurrent) {
+  std::string ids;
+  for (const auto &stage : stages) {
+    ids += (ids.empty() ? "" : ",") + std::to_string((int)stage.id);
+  }
+  record(Action::JOB, ids + ";" + (concurrent ? "1" : "0") + ";" + jobName);
+}
+
+void Recorder::recordClassification(
+    Drops::Target input,
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+        &mapping) {
+  if (mapping.empty()) {
+    return;
+  }
+  auto detail = std::to_string(static_cast<int>(input));
+  for (const auto &[in, out] : mapping) {
+    detail += ";" + colourText(in) + ">" + colourText(out);
+  }
+  record(Action::CLASSIFY, detail);
+}
+
+void Recorder::recordDrop(const Drops::Drop &drop) {
+  record(Action::LOAD, Drops::text(drop));
+}
+
+void Recorder::recordAnalysis(Drops::Target input, bool generated) {
+  record(Action::ANALYSE, std::to_string(static_cast<int>(input)) + ";" +
+                              (generated ? "1" : "0"));
+}
+
+void Recorder::watch(const Fwg::Cfg &cfg) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (active) {
+    watchLocked(cfg);
+  }
+}
+
+void Recorder::watchLocked(const Fwg::Cfg &cfg) {
+  const std::chrono::duration<double> elapsed = Clock::now() - start;
+  if (cfg.mapSeed != seed) {
+    seed = cfg.mapSeed;
+    entries.push_back({elapsed.count(), Action::SEED, std::to_string(seed)});
+  }
+  auto current = ConfigFields::flatten(cfg);
+  for (const auto &[path, value] : current) {
+    const auto known = fields.find(path);
+    // the seed has entries of its own
+    if (path == ConfigFields::seedPath ||
+        (known != fields.end() && known->second == value)) {
+      continue;
+    }
+    entries.push_back({elapsed.count(), Action::FIELD, path + "=" + value});
+  }
+  // fields of removed layers are forgotten, a replay creates added ones with
+  // default values, so all of their fields are recorded
+  fields = std::move(current);
+}
+
+bool Recorder::save(const std::string &path) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::ofstream file(path);
+  if (!file.good()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write journal ", path);
+    return false;
+  }
+  file.precision(6);
+  for (const auto &entry : entries) {
+    file << std::fixed << entry.seconds << "|"
+         << actionNames[static_cast<int>(entry.action)] << "|" << entry.detail
+         << "\n";
+  }
+  Fwg::Utils::Logging::logLine("Saved ", entries.size(),
+                               " journal entries to ", path);
+  return true;
+}
+
+bool load(const std::string &path, std::vector<Entry> &entries) {
+  std::ifstream file(path);
+  if (!file.good()) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't read journal ", path);
+    return false;
+  }
+  std::string line;
+  for (int number = 1; std::getline(file, line); number++) {
+    // the detail may contain separators itself
+    const auto first = line.find('|');
+    const auto second = line.find('|', first + 1);
+    if (first == std::string::npos || second == std::string::npos) {
+      Fwg::Utils::Logging::logLine("ERROR: Invalid journal line ", number);
+      return false;
+    }
+    const auto name = line.substr(first + 1, second - first - 1);
+    const auto action =
+        std::find(std::begin(actionNames), std::end(actionNames), name);
+    if (action == std::end(actionNames)) {
+      Fwg::Utils::Logging::logLine("ERROR: Unknown journal action ", name,
+                                   " in line ", number);
+      return false;
+    }
+    try {
+      entries.push_back({std::stod(line.substr(0, first)),
+                         static_cast<Action>(action - actionNames),
+                         line.substr(second + 1)});
+    } catch (const std::exception &) {
+      Fwg::Utils::Logging::logLine("ERROR: Invalid journal line ", number);
+      return false;
+    }
+  }
+  return true;
+}
+
+// The land and climate inputs as their tabs hold them, so classifications
+// and analyses run through the same functions as in the UI
+struct Inputs {
+  Fwg::LandUI landUI;
+  UIContext uiContext;
+  int landClassificationsNeeded = 0;
+
+  Inputs(const Fwg::Cfg &cfg, const Fwg::FastWorldGenerator &fwg) {
+    for (const auto &type : fwg.climateData.climateClassDefinitions) {
+      uiContext.climateUI.allowedClimateInputs.setValue(type.primaryColour,
+                                                        type);
+    }
+    for (const auto &landform : cfg.terrainConfig.landformDefinitions) {
+      landUI.allowedLandInputs.setValue(landform.colour, landform);
+    }
+  }
+};
+
+// the input target an entry detail starts with, false for other targets
+static bool inputTarget(const std::string &text, Drops::Target &target) {
+  const int id = std::stoi(text);
+  target = static_cast<Drops::Target>(id);
+  return target == Drops::Target::LAND_INPUT ||
+         target == Drops::Target::CLIMATE_INPUT;
+}
+
+// runs one entry, returns false if it could not be replayed
+static bool replayEntry(const Entry &entry, Fwg::Cfg &cfg,
+                        Fwg::FastWorldGenerator &fwg, Inputs &inputs) {
+  auto &landInput = inputs.landUI.landInput;
+  auto &climateInput = inputs.uiContext.climateUI.climateInputMap;
+  switch (entry.action) {
+  case Action::JOB: {
+    const auto parts = split(entry.detail, ';');
+    if (parts.size() < 3) {
+      return false;
+    }
+    std::vector<Stages::Stage> stages;
+    for (const auto &text : split(parts[0], ',')) {
+      const int id = std::stoi(text);
+      if (id < 0 || id > static_cast<int>(Stages::StageId::CONTINENTS)) {
+        return false;
+      }
+      stages.push_back(Stages::get(static_cast<Stages::StageId>(id)));
+    }
+    Stages::RunOptions options;
+    // the job name may contain the separator
+    options.jobName =
+        entry.detail.substr(parts[0].size() + parts[1].size() + 2);
+    if (parts[1] == "1") {
+      return Stages::runGraph(stages, cfg, fwg, options, true).finished;
+    }
+    return Stages::runStages(stages, cfg, fwg, options);
+  }
+  case Action::LOAD: {
+    Drops::Drop drop;
+    Fwg::Gfx::Image input;
+    if (!Drops::parse(entry.detail, drop) ||
+        !Drops::load(drop, cfg, fwg, input)) {
+      return false;
+    }
+    if (drop.target == Drops::Target::LAND_INPUT) {
+      landInput = std::move(input);
+    } else if (drop.target == Drops::Target::CLIMATE_INPUT) {
+      climateInput = std::move(input);
+    }
+    return true;
+  }
+  case Action::FIELD: {
+    // values may contain the separator, paths don't
+    const auto separator = entry.detail.find('=');
+    if (separator == std::string::npos) {
+      return false;
+    }
+    return ConfigFields::set(cfg, entry.detail.substr(0, separator),
+                             entry.detail.substr(separator + 1));
+  }
+  case Action::SEED:
+    cfg.mapSeed = std::stoi(entry.detail);
+    cfg.randomSeed = false;
+    return true;
+  case Action::CLASSIFY: {
+    const auto parts = split(entry.detail, ';');
+    Drops::Target target;
+    if (parts.empty() || !inputTarget(parts[0], target)) {
+      return false;
+    }
+    std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> mapping;
+    for (std::size_t i = 1; i < parts.size(); i++) {
+      const auto colours = split(parts[i], '>');
+      if (colours.size() != 2) {
+        return false;
+      }
+      mapping.emplace_back(parseColour(colours[0]), parseColour(colours[1]));
+    }
+    // the colours were highlighted in the UI, after the last analysis
+    if (target == Drops::Target::LAND_INPUT) {
+      if (!landInput.initialised()) {
+        return false;
+      }
+      inputs.landUI.setClassifications(mapping);
+      inputs.landUI.applyHighlighted();
+    } else {
+      if (!climateInput.initialised()) {
+        return false;
+      }
+      Climate::Input::setClassifications(mapping, inputs.uiContext);
+      Climate::Input::applyHighlighted(inputs.uiContext);
+    }
+    return true;
+  }
+  case Action::ANALYSE: {
+    const auto parts = split(entry.detail, ';');
+    Drops::Target target;
+    if (parts.size() != 2 || !inputTarget(parts[0], target)) {
+      return false;
+    }
+    if (target == Drops::Target::CLIMATE_INPUT) {
+      if (!climateInput.initialised()) {
+        return false;
+      }
+      Climate::Input::analyzeClimateMap(cfg, fwg, climateInput,
+                                        inputs.uiContext);
+      return true;
+    }
+    if (!landInput.initialised()) {
+      return false;
+    }
+    // as the Analyse Input button of the land input tab
+    const auto path = cfg.mapsPath + "/classifiedLandInput.png";
+    Fwg::Gfx::Png::save(landInput, path, false);
+    auto &needed = inputs.landClassificationsNeeded;
+    inputs.landUI.analyseLandMap(cfg, fwg, landInput, needed);
+    if (!needed) {
+      fwg.genHeightFromInput(cfg, path, cfg.landInputMode);
+    }
+    // a replay that still needs classifications went a different way
+    return (needed == 0) == (parts[1] == "1");
+  }
+  }
+  return false;
+}
+
+std::vector<Latency> replay(const std::vector<Entry> &entries, Fwg::Cfg &cfg,
+                            Fwg::FastWorldGenerator &fwg) {
+  using Clock = std::chrono::steady_clock;
+  std::vector<Latency> latencies;
+  fwg.configure(cfg);
+  // the analyses lay out ImGui items, so they need a frame, but no window or
+  // renderer
+  ImGui::CreateContext();
+  ImGuiIO &io = ImGui::GetIO();
+  io.DisplaySize = ImVec2(1920.0f, 1080.0f);
+  unsigned char *fontPixels = nullptr;
+  int fontWidth = 0;
+  int fontHeight = 0;
+  io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight);
+  ImGui::NewFrame();
+  ImGui::Begin("Replay");
+  Inputs inputs(cfg, fwg);
+  for (const auto &entry : entries) {
+    Latency latency{entry};
+    const auto start = Clock::now();
+    try {
+      latency.finished = replayEntry(entry, cfg, fwg, inputs);
+    } catch (const std::exception &e) {
+      Fwg::Utils::Logging::logLine("ERROR: Replaying ", entry.detail,
+                                   " failed: ", e.what());
+      latency.finished = false;
+    }
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    latency.seconds = elapsed.count();
+    Fwg::Utils::Logging::logLine(
+        actionNames[static_cast<int>(entry.action)], " ", entry.detail, ": ",
+        latency.seconds, "s", latency.finished ? "" : " (failed)");
+    latencies.push_back(latency);
+  }
+  ImGui::End();
+  ImGui::EndFrame();
+  ImGui::DestroyContext();
+  return latencies;
+}
+
+bool writeReport(const std::string &path,
+                 const std::vector<Latency> &latencies) {
+  namespace pt = boost::property_tree;
+  pt::ptree root;
+  pt::ptree actions;
+  double total = 0.0;
+  for (const auto &latency : latencies) {
+    pt::ptree action;
+    action.put("recordedAt", latency.entry.seconds);
+    action.put("action", actionNames[static_cast<int>(latency.entry.action)]);
+    action.put("detail", latency.entry.detail);
+    action.put("seconds", latency.seconds);
+    action.put("finished", latency.finished);
+    actions.push_back({"", action});
+    total += latency.seconds;
+  }
+  root.put("totalSeconds", total);
+  root.add_child("actions", actions);
+  try {
+    pt::write_json(path, root);
+  } catch (const std::exception &e) {
+    Fwg::Utils::Logging::logLine("ERROR: Couldn't write replay report ", path,
+                                 ": ", e.what());
+    return false;
+  }
+  return true;
+}
+
+} // namespace Fwg::UI::Journal
@@ -0,0 +1,135 @@
+#include "UI/Snapshots.h"
+
+namespace Fwg::UI::Snapshots {
+using Stages::StageId;
+
+static std::shared_ptr<const Fwg::Gfx::Image>
+share(const Fwg::Gfx::Image &image) {
+  return std::make_shared<const Fwg::Gfx::Image>(image);
+}
+
+std::shared_ptr<const Fwg::Gfx::Image> stageMap(const DataView &view,
+                                                StageId stage) {
+  switch (stage) {
+  case StageId::SEGMENTS:
+    return view.segmentMap;
+  case StageId::PROVINCES:
+    return view.provinceMap;
+  default:
+    return nullptr;
+  }
+}
+
+std::shared_ptr<const DataView>
+Channel::publish(const Fwg::FastWorldGenerator &fwg, StageId stage) {
+  std::lock_guard<std::mutex> lock(publishMutex);
+  auto view = std::make_shared<DataView>(*current.load());
+  auto &summary = view->summary;
+  const auto &terrain = fwg.terrainData;
+  const auto &climate = fwg.climateData;
+  const auto &areas = fwg.areaData;
+  switch (stage) {
+  case StageId::HEIGHTMAP:
+    summary.heightmap = !terrain.detailedHeightMap.empty();
+    break;
+  case StageId::LAND:
+    summary.landMask = !terrain.landMask.empty();
+    summary.landforms = !terrain.landFormIds.empty();
+    break;
+  case StageId::NORMALMAP:
+    summary.normalMap = !terrain.sobelData.empty();
+    break;
+  case StageId::TEMPERATURE:
+    summary.temperature = !climate.averageTemperatures.empty();
+    break;
+  case StageId::HUMIDITY:
+    summary.humidity = !climate.humidities.empty();
+    break;
+  case StageId::RIVERS:
+    summary.riverCount = (int)climate.rivers.size();
+    break;
+  case StageId::CLIMATE:
+    summary.climate = !climate.climateChances.empty();
+    break;
+  case StageId::FORESTS:
+    break;
+  case StageId::WORLDMAP:
+    summary.worldMap = fwg.worldMap.initialised();
+    break;
+  case StageId::HABITABILITY:
+    summary.habitability = !climate.habitabilities.empty();
+    break;
+  case StageId::SUPERSEGMENTS:
+    summary.superSegments = !areas.superSegments.empty();
+    break;
+  case StageId::SEGMENTS:
+    summary.segments = !areas.segments.empty();
+    summary.landSegments = (int)areas.landSegments;
+    summary.seaSegments = (int)areas.seaSegments;
+    summary.lakeSegments = (int)areas.lakeSegments;
+    view->segmentMap = share(fwg.segmentMap);
+    view->errorMap = share(fwg.errorMap);
+    break;
+  case StageId::PROVINCES:
+    summary.provinces = !areas.provinces.empty();
+    summary.provinceCount = (int)areas.provinces.size();
+    summary.provinceMap = fwg.provinceMap.initialised();
+    view->provinceMap = share(fwg.provinceMap);
+    break;
+  case StageId::CONTINENTS:
+    summary.continents = !areas.continents.empty();
+    summary.continentCount = (int)areas.continents.size();
+    summary.landBodies = !areas.landBodies.empty();
+    break;
+  }
+  view->version++;
+  current.store(view);
+  return view;
+}
+
+Summary summarize(const Fwg::FastWorldGenerator &fwg) {
+  const auto &terrain = fwg.terrainData;
+  const auto &climate = fwg.climateData;
+  const auto &areas = fwg.areaData;
+  Summary summary;
+  summary.heightmap = !terrain.detailedHeightMap.empty();
+  summary.landMask = !terrain.landMask.empty();
+  summary.landforms = !terrain.landFormIds.empty();
+  summary.normalMap = !terrain.sobelData.empty();
+  summary.temperature = !climate.averageTemperatures.empty();
+  summary.humidity = !climate.humidities.empty();
+  summary.climate = !climate.climateChances.empty();
+  summary.habitability = !climate.habitabilities.empty();
+  summary.superSegments = !areas.superSegments.empty();
+  summary.segments = !areas.segments.empty();
+  summary.provinces = !areas.provinces.empty();
+  summary.regions = !areas.regions.empty();
+  summary.landBodies = !areas.landBodies.empty();
+  summary.continents = !areas.continents.empty();
+  summary.worldMap = fwg.worldMap.initialised();
+  summary.provinceMap = fwg.provinceMap.initialised();
+  summary.riverCount = (int)climate.rivers.size();
+  summary.landSegments = (int)areas.landSegments;
+  summary.seaSegments = (int)areas.seaSegments;
+  summary.lakeSegments = (int)areas.lakeSegments;
+  summary.provinceCount = (int)areas.provinces.size();
+  summary.regionCount = (int)areas.regions.size();
+  summary.continentCount = (int)areas.continents.size();
+  return summary;
+}
+
+void Channel::publishSummary(const Fwg::FastWorldGenerator &fwg) {
+  const auto summary = summarize(fwg);
+  std::lock_guard<std::mutex> lock(publishMutex);
+  const auto previous = current.load();
+  // called every idle frame, so only allocate when something changed
+  if (previous->summary == summary) {
+    return;
+  }
+  auto view = std::make_shared<DataView>(*previous);
+  view->summary = summary;
+  view->version++;
+  current.store(view);
+}
+
+} // namespace Fwg::UI::Snapshots
@@ -0,0 +1,130 @@
+#include "UI/Staleness.h"
+#include "UI/ColdLayers.h"
+#include "UI/HeightmapCache.h"
+
+namespace Fwg::UI::Stages {
+
+void StalenessTracker::update(StageId id, bool loaded, std::size_t inputHash) {
+  cacheValid = false;
+  auto &record = records[id];
+  record.computed = true;
+  record.loaded = loaded;
+  record.inputHash = inputHash;
+  record.version = nextVersion++;
+  record.upstreamVersions.clear();
+  for (auto dependency : get(id).dependencies) {
+    const auto it = records.find(dependency);
+    record.upstreamVersions[dependency] =
+        it != records.end() ? it->second.version : 0;
+  }
+}
+
+void StalenessTracker::markComputed(StageId id, std::size_t inputHash) {
+  std::lock_guard<std::mutex> lock(mutex);
+  update(id, false, inputHash);
+}
+
+void StalenessTracker::markLoaded(StageId id) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    update(id, true, 0);
+  }
+  // the caches have locks of their own, which are never taken inside this one
+  if (id == StageId::HEIGHTMAP) {
+    // the pipeline didn't make this heightmap, held layers aren't its own
+    HeightmapCache::shared().setCurrent({});
+    ColdLayers::shared().discard();
+  }
+}
+
+void StalenessTracker::forget(StageId id) {
+  std::lock_guard<std::mutex> lock(mutex);
+  records.erase(id);
+  cacheValid = false;
+}
+
+void StalenessTracker::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  records.clear();
+  cacheValid = false;
+}
+
+void StalenessTracker::invalidate() {
+  std::lock_guard<std::mutex> lock(mutex);
+  cacheValid = false;
+}
+
+void StalenessTracker::refresh(const Fwg::Cfg &cfg) {
+  std::vector<std::size_t> inputs;
+  for (int i = 0; i <= static_cast<int>(StageId::CONTINENTS); i++) {
+    inputs.push_back(get(static_cast<StageId>(i)).inputs(cfg));
+  }
+  std::lock_guard<std::mutex> lock(mutex);
+  if (inputs != lastInputs) {
+    lastInputs = std::move(inputs);
+    cacheValid = false;
+  }
+}
+
+std::set<StageId>
+StalenessTracker::computeStale(const Fwg::Cfg &cfg) const {
+  std::set<StageId> stale;
+  for (int i = 0; i <= static_cast<int>(StageId::CONTINENTS); i++) {
+    const auto id = static_cast<StageId>(i);
+    const auto it = records.find(id);
+    if (it == records.end() || !it->second.computed) {
+      continue;
+    }
+    const auto &record = it->second;
+    const auto &stage = get(id);
+    bool isStale = !record.loaded && stage.inputs(cfg) != record.inputHash;
+    for (auto dependency : stage.dependencies) {
+      const auto upstream = records.find(dependency);
+      const unsigned long long version =
+          upstream != records.end() ? upstream->second.version : 0;
+      isStale = isStale ||
+                version != record.upstreamVersions.at(dependency) ||
+                stale.contains(dependency);
+    }
+    if (isStale) {
+      stale.insert(id);
+    }
+  }
+  return stale;
+}
+
+const std::set<StageId> &
+StalenessTracker::cached(const Fwg::Cfg &cfg) const {
+  if (!cacheValid) {
+    cachedStale = computeStale(cfg);
+    cacheValid = true;
+  }
+  return cachedStale;
+}
+
+bool StalenessTracker::isStale(StageId id, const Fwg::Cfg &cfg) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return cached(cfg).contains(id);
+}
+
+std::vector<StageId> StalenessTracker::staleIds(const Fwg::Cfg &cfg) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto &stale = cached(cfg);
+  return {stale.begin(), stale.end()};
+}
+
+std::vector<Stage>
+StalenessTracker::staleStages(const Fwg::Cfg &cfg,
+                              const std::vector<Stage> &candidates) const {
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto stale = computeStale(cfg);
+  std::vector<Stage> result;
+  for (const auto &stage : candidates) {
+    if (stale.contains(stage.id)) {
+      result.push_back(stage);
+    }
+  }
+  return result;
+}
+
+} // namespace Fwg::UI::Stages
@@ -134,8 +134,15 @@ void FwgUI::init(Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   *log << Fwg::Utils::Logging::Logger::logInstance.getFullLog();
   Fwg::Utils::Logging::Logger::logInstance.attachStream(log);
   fwg.configure(cfg);
+  uiContext.asyncContext.progress.loadHistory(cfg.workingDirectory +
+                                              "stageTimings.txt");
   heightmapUI.loadHeightmapConfigs();
+  snprintf(projectPath, sizeof(projectPath), "%s",
+           (cfg.mapsPath + "/world.fwgproj").c_str());
   initAllowedInput(cfg, fwg.climateData, cfg.terrainConfig.landformDefinitions);
+  UI::Stages::ColdLayers::shared().setScratchFolder(cfg.workingDirectory +
+                                                    "cache/");
+  initMemoryLedger(fwg);
 }
 
 void FwgUI::defaultTabs(Fwg::Cfg &cfg, FastWorldGenerator &fwg) {
@@ -143,6 +150,9 @@ void FwgUI::defaultTabs(Fwg::Cfg &cfg, FastWorldGenerator &fwg) {
   showClimateInputTab(cfg, fwg);
   showClimateOverview(cfg, fwg);
   showAreasTab(cfg, fwg);
+  showSeedExplorer(cfg, fwg);
+  showParameterSweep(cfg);
+  showMemoryTab(cfg, fwg);
 }
 
 void FwgUI::computationRunningCheck() {
@@ -157,8 +167,38 @@ void FwgUI::computationRunningCheck() {
   if (uiContext.asyncContext.computationRunning) {
     uiContext.asyncContext.computationStarted = false;
     ImGui::Text("Working, please be patient");
+    // single stages and other jobs can't be interrupted
+    auto &cancellation = uiContext.asyncContext.cancellation;
+    if (cancellation.isCancellable()) {
+      ImGui::SameLine();
+      if (cancellation.isCancelled()) {
+        ImGui::TextDisabled("Cancelling after the current stage...");
+      } else if (ImGui::Button("Cancel")) {
+        cancellation.cancel();
+      }
+    }
+    // one bar per job that reports its stages
+    for (const auto &job : uiContext.asyncContext.progress.status()) {
+      ImGui::Text("%s: %s (%d/%d)", job.jobName.c_str(),
+                  job.stageName.c_str(), job.stageIndex + 1, job.stageCount);
+      char overlay[64];
+      if (job.etaSeconds >= 0.0) {
+        snprintf(overlay, sizeof(overlay), "%.1fs elapsed, ~%.1fs left",
+                 job.elapsedSeconds, job.etaSeconds);
+      } else {
+        snprintf(overlay, sizeof(overlay), "%.1fs elapsed",
+                 job.elapsedSeconds);
+      }
+      ImGui::PushID(job.id);
+      ImGui::ProgressBar(job.fraction, ImVec2(-1.0f, 0.0f), overlay);
+      ImGui::PopID();
+    }
   } else {
     ImGui::Text("Ready!");
+    const auto summary = uiContext.asyncContext.progress.summary();
+    if (!summary.empty()) {
+      ImGui::TextDisabled("%s", summary.c_str());
+    }
   }
 }
 
@@ -196,9 +236,14 @@ int FwgUI::shiny(Fwg::FastWorldGenerator &fwg) {
   glfwSetDropCallback(
       window, [](GLFWwindow *win, int count, const char **paths) {
         auto *fwgui = reinterpret_cast<FwgUI *>(glfwGetWindowUserPointer(win));
-        fwgui->uiContext.triggeredDrag = (count > 0);
-        fwgui->uiContext.draggedFile =
-            (count > 0) ? std::string(paths[count - 1]) : "";
+        // projects aren't inputs of the shown tab
+        if (count > 0 && std::string(paths[count - 1]).ends_with(".fwgproj")) {
+          fwgui->pendingProject = paths[count - 1];
+          return;
+        }
+        if (count > 0) {
+          fwgui->pendingDrop = paths[count - 1];
+        }
       });
   // glEnable(GL_DEBUG_OUTPUT);
   // glDebugMessageCallback(DebugCallback, nullptr);
@@ -210,10 +255,18 @@ int FwgUI::shiny(Fwg::FastWorldGenerator &fwg) {
   while (!glfwWindowShouldClose(window)) {
     uiContext.triggeredDrag = false;
     glfwPollEvents();
+    if (!pendingDrop.empty() && !uiContext.asyncContext.computationRunning) {
+      uiContext.triggeredDrag = true;
+      uiContext.draggedFile = std::move(pendingDrop);
+      pendingDrop.clear();
+    }
 
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
+    // widgets, presets, sweeps and projects all change the Cfg, so the
+    // stage inputs are compared once per frame
+    uiContext.asyncContext.staleness.refresh(cfg);
     {
       ImGui::SetNextWindowPos({0, 0});
       ImGui::SetNextWindowSize({io.DisplaySize.x, io.DisplaySize.y});
@@ -236,6 +289,11 @@ int FwgUI::shiny(Fwg::FastWorldGenerator &fwg) {
                                "from left to right");
 
           if (UI::Elements::BeginMainTabBar("Steps")) {
+            uiContext.refreshDataView(fwg);
+            if (uiContext.asyncContext.computationRunning) {
+              uiContext.imageContext.showLivePreview(
+                  uiContext.asyncContext.livePreview);
+            }
             // Disable all inputs if computation is running
             if (uiContext.asyncContext.computationRunning) {
               ImGui::BeginDisabled();
@@ -322,14 +380,14 @@ int FwgUI::showFwgConfigure(Fwg::Cfg &cfg) {
 
 int FwgUI::showGeneric(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   ImGui::PushItemWidth(200.0f);
+  // runs seed the random generator from the map seed, see Stages::reseed
   if (ImGui::InputInt("<--Seed", &cfg.mapSeed)) {
     cfg.randomSeed = false;
-    cfg.reRandomize();
   }
   ImGui::SameLine();
   if (ImGui::Button("Get random seed")) {
-    cfg.randomSeed = true;
-    cfg.reRandomize();
+    cfg.mapSeed = UI::Stages::newSeed();
+    cfg.randomSeed = false;
   }
   ImGui::SameLine();
   if (cfg.debugLevel > 5 && ImGui::Button("Display size")) {
@@ -344,29 +402,216 @@ int FwgUI::showGeneric(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
     writeCurrentlyDisplayedImage(cfg);
   }
   ImGui::SameLine();
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 16);
+  ImGui::InputText("##projectPath", projectPath, sizeof(projectPath));
+  ImGui::SameLine();
+  // the project is written by a job, which must not race the others
+  const bool jobRunning = uiContext.asyncContext.computationRunning;
+  ImGui::BeginDisabled(jobRunning);
+  if (ImGui::Button("Save project")) {
+    if (std::filesystem::exists(projectPath)) {
+      ImGui::OpenPopup("Overwrite project");
+    } else {
+      saveProject(cfg, fwg, projectPath);
+    }
+  }
+  ImGui::EndDisabled();
+  if (ImGui::BeginPopupModal("Overwrite project", nullptr,
+                             ImGuiWindowFlags_AlwaysAutoResize)) {
+    ImGui::Text("%s exists, overwrite it?", projectPath);
+    if (ImGui::Button("Overwrite")) {
+      if (!uiContext.asyncContext.computationRunning) {
+        saveProject(cfg, fwg, projectPath);
+      }
+      ImGui::CloseCurrentPopup();
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Cancel")) {
+      ImGui::CloseCurrentPopup();
+    }
+    ImGui::EndPopup();
+  }
+  ImGui::SameLine();
+  if (ImGui::Button("Open project")) {
+    pendingProject = projectPath;
+  }
+  if (!pendingProject.empty() && !uiContext.asyncContext.computationRunning) {
+    openProject(cfg, fwg, pendingProject);
+    pendingProject.clear();
+  }
+  ImGui::SameLine();
+  // the journal can be replayed with --headless --replay <file>
+  auto &journal = uiContext.asyncContext.journal;
+  if (!journal.recording()) {
+    if (ImGui::Button("Record session")) {
+      journal.begin(cfg);
+    }
+  } else {
+    if (ImGui::Button("Stop recording")) {
+      journal.end();
+      journal.save(cfg.mapsPath + "/sessionJournal.txt");
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("%zu actions", journal.size());
+    // edits are journaled once the widget is released
+    if (!ImGui::IsAnyItemActive()) {
+      journal.watch(cfg);
+    }
+  }
+  ImGui::SameLine();
   ImGui::InputInt("<--Debug level", &cfg.debugLevel);
   if (ImGui::Button("Generate all fwg data")) {
-    fwg.resetData();
     // reset this because now we randomly generate all data, so heightmap
     // modifications MUST be allowed again
     cfg.allowHeightmapModification = true;
 
-    // run the generation async
+    // run the generation async, stage by stage so it can be cancelled
     uiContext.asyncContext.computationFutureBool =
         uiContext.asyncContext.runAsyncInitialDisable([&fwg, &cfg, this]() {
-          fwg.generateWorld();
+          const bool finished =
+              UI::Stages::runGraph(
+                  UI::Stages::worldStages(), cfg, fwg,
+                  uiContext.asyncContext.runOptions("Generate all fwg data",
+                                                    true),
+                  uiContext.generationContext.concurrentStages)
+                  .finished;
           uiContext.imageContext.resetTexture();
           uiContext.generationContext.modifiedAreas = true;
-          return true;
+          return finished;
         });
   }
+  ImGui::SameLine();
+  ImGui::Checkbox("Overlap isolated stages",
+                  &uiContext.generationContext.concurrentStages);
+  if (ImGui::IsItemHovered()) {
+    ImGui::SetTooltip("Runs stages that touch no shared data next to the "
+                      "others. Only the normal map does so far, every other "
+                      "stage shares the generator's data and random engine "
+                      "and runs after the one before.");
+  }
+  // noise layers are only read up to the land stage
+  auto &coldLayers = UI::Stages::ColdLayers::shared();
+  int leanMode = static_cast<int>(coldLayers.mode.load());
+  ImGui::SameLine();
+  ImGui::SetNextItemWidth(ImGui::GetFontSize() * 12);
+  if (ImGui::Combo("Lean memory", &leanMode,
+                   "Off\0Compress layers\0Spill layers to disk\0")) {
+    coldLayers.mode = static_cast<UI::Stages::LeanMode>(leanMode);
+    // cached heightmaps hold full copies of the layers
+    if (coldLayers.mode != UI::Stages::LeanMode::OFF) {
+      UI::Stages::HeightmapCache::shared().clear();
+    }
+  }
+  if (coldLayers.frozen()) {
+    ImGui::SameLine();
+    ImGui::Text("saved %.1f MB", coldLayers.savedBytes() / (1024.0 * 1024.0));
+  }
+
+  // stages whose inputs changed since they ran, their tabs are highlighted
+  const auto staleIds = uiContext.asyncContext.staleness.staleIds(cfg);
+  if (!staleIds.empty()) {
+    std::string staleNames;
+    for (const auto id : staleIds) {
+      staleNames += (staleNames.empty() ? "" : ", ") + UI::Stages::get(id).name;
+    }
+    if (ImGui::Button("Recompute stale only")) {
+      const auto staleStages = uiContext.asyncContext.staleness.staleStages(
+          cfg, UI::Stages::worldStages());
+      uiContext.asyncContext.computationFutureBool =
+          uiContext.asyncContext.runAsync([&fwg, &cfg, staleStages, this]() {
+            const bool finished =
+                UI::Stages::runGraph(
+                    staleStages, cfg, fwg,
+                    uiContext.asyncContext.runOptions("Recompute stale"),
+                    uiContext.generationContext.concurrentStages)
+                    .finished;
+            uiContext.imageContext.resetTexture();
+            return finished;
+          });
+    }
+    ImGui::SameLine();
+    ImGui::TextWrapped("Stale: %s", staleNames.c_str());
+  }
   ImGui::PopItemWidth();
   return true;
 }
 
+void FwgUI::saveProject(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                        const std::string &path) {
+  // the UI keeps editing the Cfg and the inputs while the job writes, so it
+  // writes copies of them
+  UI::Project::Input landInput{landUI.landInput, {}};
+  UI::Project::Input climateInput{uiContext.climateUI.climateInputMap, {}};
+  // the classifications picked but not applied yet
+  for (const auto &[colour, input] : landUI.landInputColours.getMap()) {
+    if (input.in != input.out) {
+      landInput.mapping.emplace_back(input.in, input.out);
+    }
+  }
+  for (const auto &[colour, input] :
+       uiContext.climateUI.climateInputColours.getMap()) {
+    if (input.in != input.out) {
+      climateInput.mapping.emplace_back(input.in, input.out);
+    }
+  }
+  uiContext.asyncContext.computationFutureBool =
+      uiContext.asyncContext.runAsync(
+          [&fwg, cfg, path, landInput = std::move(landInput),
+           climateInput = std::move(climateInput)]() {
+            return UI::Project::save(path, cfg, fwg, landInput, climateInput);
+          });
+}
+
+bool FwgUI::openProject(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
+                        const std::string &path) {
+  if (!project.open(path, cfg)) {
+    return false;
+  }
+  UI::Stages::ColdLayers::shared().discard();
+  fwg.resetData();
+  fwg.configure(cfg);
+  uiContext.asyncContext.staleness.clear();
+  // the inputs are restored once their tab is shown
+  landUI.landInput.clear();
+  landUI.inputHistory.clear();
+  uiContext.climateUI.climateInputMap.clear();
+  uiContext.climateUI.inputHistory.clear();
+  // the area tabs show their maps from the published view
+  auto materialise = [&fwg, this](UI::Project::Part part) {
+    project.materialise(part, fwg, uiContext.asyncContext.staleness);
+    if (part == UI::Project::Part::AREAS) {
+      auto &snapshots = uiContext.asyncContext.snapshots;
+      snapshots.publish(fwg, UI::Stages::StageId::SEGMENTS);
+      snapshots.publish(fwg, UI::Stages::StageId::PROVINCES);
+    }
+  };
+  // the shown part is copied right away, the others in the background
+  auto parts = project.generatorParts(shownPart);
+  if (!parts.empty()) {
+    materialise(parts.front());
+    parts.erase(parts.begin());
+  }
+  uiContext.imageContext.resetTexture();
+  if (!parts.empty()) {
+    uiContext.asyncContext.computationFutureBool =
+        uiContext.asyncContext.runAsync([parts, materialise, this]() {
+          for (const auto part : parts) {
+            materialise(part);
+          }
+          uiContext.imageContext.resetTexture();
+          return true;
+        });
+  }
+  // saving goes back to the opened file
+  snprintf(projectPath, sizeof(projectPath), "%s", path.c_str());
+  Fwg::Utils::Logging::logLine("Opened project ", path);
+  return true;
+}
+
 int FwgUI::showElevationTabs(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 
   if (UI::Elements::BeginMainTabItem("Land Tabs")) {
+    shownPart = UI::Project::Part::TERRAIN;
     uiContext.tabSwitchEvent();
     if (UI::Elements::BeginSubTabBar("Land Tabs", 0.0f)) {
       showLandTab(cfg, fwg);
@@ -381,6 +626,16 @@ int FwgUI::showElevationTabs(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 
 int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   if (UI::Elements::BeginSubTabItem("Land Input")) {
+    if (project.pending(UI::Project::Part::LAND_INPUT)) {
+      Fwg::Gfx::Image image;
+      UI::Project::Mapping mapping;
+      if (project.input(UI::Project::Part::LAND_INPUT, image, mapping)) {
+        landUI.restoreInput(
+            cfg, fwg, image, mapping,
+            uiContext.generationContext.amountClassificationsNeeded);
+        uiContext.imageContext.resetTexture();
+      }
+    }
     if (uiContext.tabSwitchEvent(true)) {
       uiContext.imageContext.updateImage(0, landUI.landInput);
       uiContext.imageContext.updateImage(1, Fwg::Gfx::Image());
@@ -396,8 +651,8 @@ int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
                        cfg.landInputMode == Fwg::Terrain::InputMode::HEIGHTMAP);
     if (ImGui::IsItemClicked()) {
       cfg.landInputMode = Fwg::Terrain::InputMode::HEIGHTMAP;
-      cfg.readHeightmapConfig(cfg.workingDirectory + "configs/heightmap/" +
-                              "default.json");
+      heightmapUI.applyPreset(cfg, cfg.workingDirectory +
+                                       "configs/heightmap/default.json");
       cfg.terrainConfig.heightmapPipeline =
           Fwg::Terrain::createDefaultPipeline();
     }
@@ -414,8 +669,8 @@ int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
     ImGui::RadioButton("Land Mask. A simple land/water mask",
                        cfg.landInputMode == Fwg::Terrain::InputMode::LANDMASK);
     if (ImGui::IsItemClicked()) {
-      cfg.readHeightmapConfig(cfg.workingDirectory + "configs/heightmap/" +
-                              "default.json");
+      heightmapUI.applyPreset(cfg, cfg.workingDirectory +
+                                       "configs/heightmap/default.json");
       cfg.landInputMode = Fwg::Terrain::InputMode::LANDMASK;
       cfg.terrainConfig.heightmapPipeline =
           Fwg::Terrain::createDefaultPipeline();
@@ -426,8 +681,8 @@ int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
         cfg.landInputMode == Fwg::Terrain::InputMode::LANDFORM);
     if (ImGui::IsItemClicked()) {
       cfg.landInputMode = Fwg::Terrain::InputMode::LANDFORM;
-      cfg.readHeightmapConfig(cfg.workingDirectory + "configs/heightmap/" +
-                              "mappedInput.json");
+      heightmapUI.applyPreset(cfg, cfg.workingDirectory +
+                                       "configs/heightmap/mappedInput.json");
       cfg.terrainConfig.heightmapPipeline =
           Fwg::Terrain::createLandformPipeline();
     }
@@ -442,8 +697,14 @@ int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
       cfg.allowHeightmapModification = true;
       uiContext.asyncContext.computationFutureBool =
           uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
+            uiContext.asyncContext.journal.recordDrop(
+                {UI::Drops::Target::LAND_INPUT, uiContext.draggedFile});
             landUI.triggeredLandInput(cfg, fwg, uiContext.draggedFile,
                                       cfg.landInputMode);
+            // the input replaced all generator data
+            uiContext.asyncContext.staleness.clear();
+            uiContext.asyncContext.staleness.markLoaded(
+                UI::Stages::StageId::HEIGHTMAP);
 
             // in case of complex input and a drag, we NEED to initially analyze
             if (cfg.landInputMode == Fwg::Terrain::InputMode::LANDFORM) {
@@ -460,7 +721,9 @@ int FwgUI::showLandTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 }
 
 int FwgUI::showNormalMapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
-  if (UI::Elements::BeginSubTabItem("Normalmap")) {
+  if (UI::Elements::BeginSubTabItem(
+          "Normalmap",
+          uiContext.staleTab(UI::Stages::StageId::NORMALMAP, cfg))) {
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(
           0, Fwg::Gfx::displaySobelMap(fwg.terrainData.sobelData));
@@ -478,30 +741,35 @@ int FwgUI::showNormalMapTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 
     ImGui::Spacing();
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary())});
 
     if (guard.ready()) {
       if (UI::Elements::ImportantStepButton("Generate Normalmap",
                                             ImVec2(200, 0))) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
-              fwg.genSobelMap(cfg);
+              const bool finished = UI::Stages::runStage(
+                  UI::Stages::StageId::NORMALMAP, cfg, fwg,
+                  uiContext.asyncContext.runOptions("Normalmap"));
               uiContext.imageContext.resetTexture(0);
-              return true;
+              return finished;
             });
       }
     }
 
     if (uiContext.triggeredDrag) {
       uiContext.triggeredDrag = false;
-      auto heightMap =
-          IO::Reader::readHeightmapImage(uiContext.draggedFile, cfg);
-      fwg.loadHeight(cfg, heightMap);
+      uiContext.asyncContext.loadDrop(
+          {UI::Drops::Target::HEIGHTMAP, uiContext.draggedFile}, cfg, fwg);
+      uiContext.asyncContext.staleness.markLoaded(
+          UI::Stages::StageId::HEIGHTMAP);
       uiContext.asyncContext.computationFutureBool =
           uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
-            fwg.genSobelMap(cfg);
+            const bool finished = UI::Stages::runStage(
+                UI::Stages::StageId::NORMALMAP, cfg, fwg,
+                uiContext.asyncContext.runOptions("Normalmap"));
             uiContext.imageContext.resetTexture();
-            return true;
+            return finished;
           });
     }
 
@@ -515,6 +783,15 @@ int FwgUI::showClimateInputTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   if (UI::Elements::BeginMainTabItem("Climate Input")) {
     static bool analyze = false;
     static int amountClassificationsNeeded = 0;
+    shownPart = UI::Project::Part::CLIMATE;
+    if (project.pending(UI::Project::Part::CLIMATE_INPUT)) {
+      Fwg::Gfx::Image image;
+      UI::Project::Mapping mapping;
+      if (project.input(UI::Project::Part::CLIMATE_INPUT, image, mapping)) {
+        UI::Climate::Input::restoreInput(cfg, fwg, image, mapping, uiContext);
+        uiContext.imageContext.resetTexture();
+      }
+    }
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.updateImage(0, uiContext.climateUI.climateInputMap);
       uiContext.imageContext.updateImage(1, Fwg::Gfx::Image());
@@ -523,9 +800,9 @@ int FwgUI::showClimateInputTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
                          "random climate in the next tab");
     uiContext.helpContext.showHelpTextBox("Climate Input");
     auto guard = UI::PrerequisiteChecker::require(
-        {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-         UI::PrerequisiteChecker::landforms(fwg.terrainData),
-         UI::PrerequisiteChecker::landMask(fwg.terrainData)});
+        {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+         UI::PrerequisiteChecker::landforms(uiContext.summary()),
+         UI::PrerequisiteChecker::landMask(uiContext.summary())});
 
     if (guard.ready()) {
       if (uiContext.triggeredDrag) {
@@ -534,34 +811,12 @@ int FwgUI::showClimateInputTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
             uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
               // don't immediately generate from the input, instead allow to
               // manually classify all present colours
-              uiContext.climateUI.climateInputMap =
-                  Fwg::IO::Reader::readGenericImage(uiContext.draggedFile, cfg);
-              // create a map from secondary colours to primary colours
-              Fwg::Utils::ColourTMap<Fwg::Climate::ClimateClassDefinition>
-                  secondaryToPrimary;
-              for (auto &type : fwg.climateData.climateClassDefinitions) {
-                for (auto &secondary : type.secondaryColours) {
-                  secondaryToPrimary.setValue(secondary, type);
-                }
-              }
-
-              // preprocess input to convert to primary colours where possible
-              for (auto &col : uiContext.climateUI.climateInputMap.imageData) {
-                if (secondaryToPrimary.contains(col)) {
-                  col = secondaryToPrimary[col].primaryColour;
-                }
-              }
-
-              if (uiContext.climateUI.climateInputMap.size() !=
-                  fwg.terrainData.detailedHeightMap.size()) {
-                Utils::Logging::logLine(
-                    "Climate input map size does not match height "
-                    "map size. Please ensure that the input map is "
-                    "the same size as the height map");
-                uiContext.climateUI.climateInputMap.clear();
-              } else {
+              if (uiContext.asyncContext.loadDrop(
+                      {UI::Drops::Target::CLIMATE_INPUT, uiContext.draggedFile},
+                      cfg, fwg, uiContext.climateUI.climateInputMap)) {
                 analyze = true;
               }
+              uiContext.climateUI.inputHistory.clear();
               uiContext.imageContext.resetTexture();
               return true;
             });
@@ -587,7 +842,12 @@ int FwgUI::showClimateInputTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
             cfg.complexClimateInput = true;
             Fwg::Gfx::Png::save(uiContext.climateUI.climateInputMap,
                                 cfg.mapsPath + "/classifiedClimateInput.png");
-            fwg.loadClimate(cfg, uiContext.climateUI.climateInputMap);
+            // the same load as dropping a climate with a classified input
+            uiContext.asyncContext.loadDrop(
+                {UI::Drops::Target::CLIMATE, "", true}, cfg, fwg,
+                uiContext.climateUI.climateInputMap);
+            uiContext.asyncContext.staleness.markLoaded(
+                UI::Stages::StageId::CLIMATE);
             uiContext.imageContext.resetTexture();
             return true;
           });
@@ -600,6 +860,7 @@ int FwgUI::showClimateInputTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 
 int FwgUI::showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   if (UI::Elements::BeginMainTabItem("Climate Generation")) {
+    shownPart = UI::Project::Part::CLIMATE;
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.resetTexture();
     }
@@ -610,20 +871,16 @@ int FwgUI::showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
     {
       UI::Elements::GridLayout grid(2, 200.0f, 12.0f);
 
-      if (grid.AddInputDouble("Base Temperature", &cfg.baseTemperature, -100.0,
-                              100.0) |
-          grid.AddInputDouble("Base Humidity", &cfg.baseHumidity, 0.0, 100.0) |
-          grid.AddInputDouble("Fantasy Frequency", &cfg.fantasyClimateFrequency,
-                              0.0, 10.0)) {
-        uiContext.generationContext.redoHumidity = true;
-      }
+      // changes here mark the stages reading them stale
+      grid.AddInputDouble("Base Temperature", &cfg.baseTemperature, -100.0,
+                          100.0);
+      grid.AddInputDouble("Base Humidity", &cfg.baseHumidity, 0.0, 100.0);
+      grid.AddInputDouble("Fantasy Frequency", &cfg.fantasyClimateFrequency,
+                          0.0, 10.0);
 
       // Fantasy climate checkbox on new row
       grid.NextRow();
       ImGui::Checkbox("Fantasy Climate", &cfg.fantasyClimate);
-      if (ImGui::IsItemDeactivatedAfterEdit()) {
-        uiContext.generationContext.redoHumidity = true;
-      }
     }
 
     ImGui::Spacing();
@@ -632,15 +889,13 @@ int FwgUI::showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
     {
       UI::Elements::GridLayout grid(2, 200.0f, 12.0f);
 
-      if (grid.AddInputDouble("Latitude High", &cfg.latHigh, -90.0, 90.0) |
-          grid.AddInputDouble("Latitude Low", &cfg.latLow, -90.0, 90.0) |
-          grid.AddInputDouble("River Amount", &cfg.riverFactor, 0.0, 10.0) |
-          grid.AddInputDouble("River Humidity", &cfg.riverHumidityFactor, 0.0,
-                              10.0) |
-          grid.AddInputDouble("River Range", &cfg.riverEffectRangeFactor, 0.0,
-                              10.0)) {
-        uiContext.generationContext.redoHumidity = true;
-      }
+      grid.AddInputDouble("Latitude High", &cfg.latHigh, -90.0, 90.0);
+      grid.AddInputDouble("Latitude Low", &cfg.latLow, -90.0, 90.0);
+      grid.AddInputDouble("River Amount", &cfg.riverFactor, 0.0, 10.0);
+      grid.AddInputDouble("River Humidity", &cfg.riverHumidityFactor, 0.0,
+                          10.0);
+      grid.AddInputDouble("River Range", &cfg.riverEffectRangeFactor, 0.0,
+                          10.0);
     }
 
     ImGui::Spacing();
@@ -648,20 +903,21 @@ int FwgUI::showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
     // Scoped guard - only affects the automation button
     {
       auto guard = UI::PrerequisiteChecker::require(
-          {UI::PrerequisiteChecker::heightmap(fwg.terrainData),
-           UI::PrerequisiteChecker::landforms(fwg.terrainData),
-           UI::PrerequisiteChecker::landMask(fwg.terrainData)});
+          {UI::PrerequisiteChecker::heightmap(uiContext.summary()),
+           UI::PrerequisiteChecker::landforms(uiContext.summary()),
+           UI::PrerequisiteChecker::landMask(uiContext.summary())});
       if (guard.ready() && UI::Elements::AutomationStepButton(
                                "Generate whole climate automatically")) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
-              fwg.genTemperatures(cfg);
-              fwg.genHumidity(cfg);
-              fwg.genRivers(cfg);
-              fwg.genClimate(cfg);
-              fwg.genWorldMap(cfg);
+              const bool finished =
+                  UI::Stages::runGraph(
+                      UI::Stages::climateStages(), cfg, fwg,
+                      uiContext.asyncContext.runOptions("Climate"),
+                      uiContext.generationContext.concurrentStages)
+                      .finished;
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
     }
@@ -683,26 +939,28 @@ int FwgUI::showClimateOverview(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 int FwgUI::showAreasTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
 
   if (UI::Elements::BeginMainTabItem("Areas")) {
+    shownPart = UI::Project::Part::AREAS;
     if (uiContext.tabSwitchEvent()) {
       uiContext.imageContext.resetTexture();
     }
     {
       auto guard = UI::PrerequisiteChecker::require(
-          {UI::PrerequisiteChecker::climate(fwg.climateData),
-           UI::PrerequisiteChecker::landforms(fwg.terrainData)});
+          {UI::PrerequisiteChecker::climate(uiContext.summary()),
+           UI::PrerequisiteChecker::landforms(uiContext.summary())});
 
       if (guard.ready() && UI::Elements::AutomationStepButton(
                                "Generate all areas automatically")) {
         uiContext.asyncContext.computationFutureBool =
             uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
               uiContext.generationContext.modifiedAreas = true;
-              fwg.genHabitability(cfg);
-              fwg.genSuperSegments(cfg);
-              fwg.genSegments(cfg);
-              fwg.genProvinces();
-              fwg.genContinents(cfg);
+              const bool finished =
+                  UI::Stages::runGraph(
+                      UI::Stages::areaStages(), cfg, fwg,
+                      uiContext.asyncContext.runOptions("Areas"),
+                      uiContext.generationContext.concurrentStages)
+                      .finished;
               uiContext.imageContext.resetTexture();
-              return true;
+              return finished;
             });
       }
     }
@@ -722,4 +980,394 @@ int FwgUI::showAreasTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
   return 0;
 }
 
+int FwgUI::showSeedExplorer(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+  if (UI::Elements::BeginMainTabItem("Seed Explorer")) {
+    uiContext.tabSwitchEvent();
+    ImGui::TextWrapped("Generates the land of many seeds at a reduced "
+                       "resolution. Click a world to generate it at full "
+                       "resolution.");
+    ImGui::PushItemWidth(120.0f);
+    ImGui::InputInt("Worlds", &seedExplorer.count);
+    seedExplorer.count = std::clamp(seedExplorer.count, 1, 64);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/4", &seedExplorer.scale, 4);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/8", &seedExplorer.scale, 8);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/16", &seedExplorer.scale, 16);
+    ImGui::PopItemWidth();
+    ImGui::Checkbox("Random seeds instead of the ones after the current seed",
+                    &seedExplorer.randomSeeds);
+    if (ImGui::Button("Explore seeds")) {
+      seedExplorer.start(cfg);
+    }
+    if (seedExplorer.running()) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("Generating...");
+    }
+    seedExplorer.update();
+
+    const ImVec2 thumbnailSize(200.0f, 100.0f);
+    const float spacing = ImGui::GetStyle().ItemSpacing.x;
+    const int perRow =
+        std::max(1, (int)((ImGui::GetContentRegionAvail().x + spacing) /
+                          (thumbnailSize.x + spacing)));
+    const auto &grid = seedExplorer.grid();
+    for (int i = 0; i < (int)grid.size(); i++) {
+      const auto &cell = grid[i];
+      ImGui::PushID(i);
+      ImGui::BeginGroup();
+      if (cell.texture) {
+        ImGui::Image((ImTextureID)(intptr_t)cell.texture, thumbnailSize);
+      } else {
+        ImGui::Dummy(thumbnailSize);
+      }
+      ImGui::Text("Seed %d", cell.seed);
+      if (cell.done && cell.result.finished) {
+        ImGui::TextDisabled("%.0f%% land, %d continents",
+                            cell.result.landShare * 100.0,
+                            cell.result.continents);
+      } else {
+        ImGui::TextDisabled(cell.done ? "Failed" : "Waiting...");
+      }
+      ImGui::EndGroup();
+      if (cell.done && ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Generated in %.2fs, click to use this seed\n"
+                          "Continents are landmasses covering at least half "
+                          "a percent of the map",
+                          cell.result.seconds);
+      }
+      if (cell.done && ImGui::IsItemClicked() &&
+          !uiContext.asyncContext.computationRunning) {
+        cfg.mapSeed = cell.seed;
+        cfg.randomSeed = false;
+        uiContext.asyncContext.computationFutureBool =
+            uiContext.asyncContext.runAsync([&fwg, &cfg, this]() {
+              const bool finished = UI::Stages::runStages(
+                  {UI::Stages::get(UI::Stages::StageId::HEIGHTMAP),
+                   UI::Stages::get(UI::Stages::StageId::LAND)},
+                  cfg, fwg,
+                  uiContext.asyncContext.runOptions("Explored seed"));
+              uiContext.imageContext.resetTexture();
+              return finished;
+            });
+      }
+      ImGui::PopID();
+      if ((i + 1) % perRow != 0) {
+        ImGui::SameLine();
+      }
+    }
+    ImGui::EndTabItem();
+  }
+  return 0;
+}
+
+int FwgUI::showParameterSweep(Fwg::Cfg &cfg) {
+  if (UI::Elements::BeginMainTabItem("Parameter Sweep")) {
+    uiContext.tabSwitchEvent();
+    ImGui::TextWrapped("Generates one world per combination of parameter "
+                       "values, running only the stages up to the last one "
+                       "that reads them. Click a world to use its values.");
+    const auto &parameters = UI::ParameterSweep::parameters();
+    auto axisEditor = [&parameters](const char *label,
+                                    UI::ParameterSweep::Axis &axis) {
+      ImGui::PushID(label);
+      ImGui::PushItemWidth(180.0f);
+      if (ImGui::BeginCombo(label, parameters[axis.parameter].name)) {
+        for (int i = 0; i < (int)parameters.size(); i++) {
+          if (ImGui::Selectable(parameters[i].name, i == axis.parameter)) {
+            axis.parameter = i;
+            axis.from = parameters[i].minimum;
+            axis.to = parameters[i].maximum;
+          }
+        }
+        ImGui::EndCombo();
+      }
+      ImGui::PopItemWidth();
+      ImGui::PushItemWidth(100.0f);
+      const auto &parameter = parameters[axis.parameter];
+      ImGui::SameLine();
+      ImGui::InputDouble("From", &axis.from);
+      ImGui::SameLine();
+      ImGui::InputDouble("To", &axis.to);
+      ImGui::SameLine();
+      ImGui::InputInt("Steps", &axis.steps);
+      axis.from = std::clamp(axis.from, parameter.minimum, parameter.maximum);
+      axis.to = std::clamp(axis.to, parameter.minimum, parameter.maximum);
+      axis.steps = std::clamp(axis.steps, 1, 12);
+      ImGui::PopItemWidth();
+      ImGui::PopID();
+    };
+    axisEditor("Columns", parameterSweep.x);
+    ImGui::Checkbox("Sweep a second parameter", &parameterSweep.twoParameters);
+    if (parameterSweep.twoParameters) {
+      axisEditor("Rows", parameterSweep.y);
+    }
+    ImGui::RadioButton("Full size", &parameterSweep.scale, 1);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/2", &parameterSweep.scale, 2);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/4", &parameterSweep.scale, 4);
+    ImGui::SameLine();
+    ImGui::RadioButton("1/8", &parameterSweep.scale, 8);
+    if (ImGui::Button("Run sweep")) {
+      parameterSweep.start(cfg);
+    }
+    if (!parameterSweep.empty()) {
+      ImGui::SameLine();
+      if (ImGui::Button("Export CSV")) {
+        parameterSweep.writeCsv(cfg.mapsPath + "/parameterSweep.csv");
+      }
+    }
+    if (parameterSweep.running()) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("Generating...");
+    }
+    parameterSweep.update();
+
+    const ImVec2 thumbnailSize(200.0f, 100.0f);
+    const auto &matrix = parameterSweep.matrix();
+    const int columns = parameterSweep.columns();
+    for (int i = 0; i < (int)matrix.size(); i++) {
+      const auto &cell = matrix[i];
+      ImGui::PushID(i);
+      ImGui::BeginGroup();
+      if (cell.texture) {
+        ImGui::Image((ImTextureID)(intptr_t)cell.texture, thumbnailSize);
+      } else {
+        ImGui::Dummy(thumbnailSize);
+      }
+      if (parameterSweep.sweepsTwo()) {
+        ImGui::Text("%.3g / %.3g", cell.x, cell.y);
+      } else {
+        ImGui::Text("%.3g", cell.x);
+      }
+      if (cell.done && cell.result.finished) {
+        ImGui::TextDisabled("%.2fs, %.0f%% land, %d continents",
+                            cell.result.seconds, cell.result.landShare * 100.0,
+                            cell.result.continents);
+      } else {
+        ImGui::TextDisabled(cell.done ? "Failed" : "Waiting...");
+      }
+      ImGui::EndGroup();
+      if (cell.done && ImGui::IsItemHovered()) {
+        std::string tooltip;
+        for (const auto &[stage, seconds] : cell.result.stageSeconds) {
+          tooltip += stage + ": " + std::to_string(seconds) + "s\n";
+        }
+        ImGui::SetTooltip("%s%d rivers, %d provinces", tooltip.c_str(),
+                          cell.result.summary.riverCount,
+                          cell.result.summary.provinceCount);
+      }
+      if (cell.done && ImGui::IsItemClicked()) {
+        parameterSweep.apply(cell, cfg);
+      }
+      ImGui::PopID();
+      if ((i + 1) % columns != 0) {
+        ImGui::SameLine();
+      }
+    }
+    ImGui::EndTabItem();
+  }
+  return 0;
+}
+
+void FwgUI::initMemoryLedger(Fwg::FastWorldGenerator &fwg) {
+  using UI::Memory::heapBytes;
+  using UI::Memory::Item;
+  auto terrain = [&data = fwg.terrainData]() {
+    UI::Memory::Seen seen;
+    return std::vector<Item>{
+        {"Heightmap", heapBytes(data.detailedHeightMap, seen)},
+        {"Land mask", heapBytes(data.landMask, seen)},
+        {"Landform ids", heapBytes(data.landFormIds, seen)},
+        {"Sobel data", heapBytes(data.sobelData, seen)},
+        {"Shape layers", heapBytes(data.shapeLayers, seen)},
+        {"Land layers", heapBytes(data.landLayers, seen)},
+        {"Sea layers", heapBytes(data.seaLayers, seen)}};
+  };
+  auto climate = [&data = fwg.climateData]() {
+    UI::Memory::Seen seen;
+    return std::vector<Item>{
+        {"Temperatures", heapBytes(data.averageTemperatures, seen)},
+        {"Humidities", heapBytes(data.humidities, seen)},
+        {"Habitabilities", heapBytes(data.habitabilities, seen)},
+        {"Climate chances", heapBytes(data.climateChances, seen)},
+        {"Rivers", heapBytes(data.rivers, seen)},
+        {"Climate classes", heapBytes(data.climateClassDefinitions, seen)}};
+  };
+  // provinces are shared between segments, regions and continents, seen
+  // counts each of them once
+  auto areas = [&data = fwg.areaData]() {
+    using UI::Memory::areaBytes;
+    UI::Memory::Seen seen;
+    return std::vector<Item>{
+        {"Provinces", areaBytes(data.provinces, seen)},
+        {"Segments", areaBytes(data.segments, seen)},
+        {"Super segments", areaBytes(data.superSegments, seen)},
+        {"Regions", areaBytes(data.regions, seen)},
+        {"Continents", heapBytes(data.continents, seen)},
+        {"Sea bodies", heapBytes(data.seaBodies, seen)}};
+  };
+  auto images = [&fwg]() {
+    return std::vector<Item>{{"World map", heapBytes(fwg.worldMap)},
+                             {"Segment map", heapBytes(fwg.segmentMap)},
+                             {"Province map", heapBytes(fwg.provinceMap)},
+                             {"Error map", heapBytes(fwg.errorMap)}};
+  };
+  auto copies = [this]() {
+    auto pixelLists = [](const auto &colours) {
+      std::size_t bytes = 0;
+      for (const auto &entry : colours.getMap()) {
+        bytes += heapBytes(entry.second.pixels);
+      }
+      return bytes;
+    };
+    // both views may show the same image, which then counts once
+    const auto &active = uiContext.imageContext.activeImages;
+    UI::Memory::Seen seen;
+    const auto displayed =
+        heapBytes(active[0], seen) + heapBytes(active[1], seen);
+    const auto &climateUI = uiContext.climateUI;
+    return std::vector<Item>{
+        {"Displayed images", displayed},
+        {"Land input", heapBytes(landUI.landInput)},
+        {"Land classification pixels", pixelLists(landUI.landInputColours)},
+        {"Climate input", heapBytes(climateUI.climateInputMap)},
+        {"Input edit history",
+         landUI.inputHistory.bytes() + climateUI.inputHistory.bytes()},
+        {"Climate classification pixels",
+         pixelLists(climateUI.climateInputColours)}};
+  };
+  auto caches = []() {
+    return std::vector<Item>{
+        {"Heightmap cache", UI::Stages::HeightmapCache::shared().bytes()},
+        {"Frozen layers", UI::Stages::ColdLayers::shared().heldBytes()}};
+  };
+  // textures are RGBA with 8 bits per channel, see getResourceView
+  auto textures = [this]() {
+    auto bytes = [](GLuint texture, const Fwg::Gfx::Image &image) {
+      return texture ? static_cast<std::size_t>(image.width()) *
+                           image.height() * 4
+                     : 0;
+    };
+    const auto &imageContext = uiContext.imageContext;
+    const auto &help = uiContext.helpContext;
+    // the help images are freed once uploaded, only their sizes are kept
+    std::size_t helpBytes = 0;
+    for (const auto &[key, size] : help.advancedHelpTextureSizes) {
+      helpBytes += static_cast<std::size_t>(size.first) * size.second * 4;
+    }
+    std::size_t thumbnailBytes = 0;
+    for (const auto &cell : seedExplorer.grid()) {
+      thumbnailBytes += bytes(cell.texture, cell.result.thumbnail);
+    }
+    for (const auto &cell : parameterSweep.matrix()) {
+      thumbnailBytes += bytes(cell.texture, cell.result.thumbnail);
+    }
+    return std::vector<Item>{
+        {"Primary view",
+         bytes(imageContext.primaryTexture, imageContext.activeImage(0))},
+        // a texture shared with the primary view is counted there
+        {"Secondary view",
+         imageContext.secondaryTexture == imageContext.primaryTexture
+             ? 0
+             : bytes(imageContext.secondaryTexture,
+                     imageContext.activeImage(1))},
+        {"Help images", helpBytes},
+        {"Explorer and sweep thumbnails", thumbnailBytes}};
+  };
+  memoryLedger.add({"Terrain", true, terrain});
+  memoryLedger.add({"Climate", true, climate});
+  memoryLedger.add({"Areas", true, areas});
+  memoryLedger.add({"Generator images", true, images});
+  memoryLedger.add({"UI copies", false, copies});
+  memoryLedger.add({"Caches", false, caches});
+  memoryLedger.add({"GPU textures", false, textures});
+}
+
+int FwgUI::showMemoryTab(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg) {
+  if (UI::Elements::BeginMainTabItem("Memory")) {
+    uiContext.tabSwitchEvent();
+    memoryLedger.update(uiContext.asyncContext.computationRunning);
+    auto megabytes = [](std::size_t bytes) {
+      return static_cast<double>(bytes) / (1024.0 * 1024.0);
+    };
+    const auto total = memoryLedger.total();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - processSampled > std::chrono::seconds(1)) {
+      processSample = UI::sampleProcess();
+      processSampled = now;
+    }
+    ImGui::Text("Accounted: %.1f MB", megabytes(total));
+    if (processSample.residentBytes) {
+      ImGui::SameLine();
+      ImGui::TextDisabled("(process resident: %.1f MB)",
+                          megabytes(processSample.residentBytes));
+    }
+    ImGui::PushItemWidth(120.0f);
+    ImGui::InputInt("Budget in MB", &memoryBudgetMb, 256);
+    memoryBudgetMb = std::max(memoryBudgetMb, 64);
+    ImGui::PopItemWidth();
+    const auto budget = static_cast<std::size_t>(memoryBudgetMb) << 20;
+
+    // the generator data grows with the map, so its current bytes per pixel
+    // tell what a generation at the configured size would hold
+    const auto generated = fwg.terrainData.detailedHeightMap.size();
+    const auto configured = static_cast<std::size_t>(cfg.width) * cfg.height;
+    std::size_t projected = total;
+    if (generated && !uiContext.asyncContext.computationRunning) {
+      projected = total - memoryLedger.generatorTotal() +
+                  static_cast<std::size_t>(
+                      static_cast<double>(memoryLedger.generatorTotal()) *
+                      configured / generated);
+    }
+    if (total > budget) {
+      ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f),
+                         "Over budget by %.1f MB",
+                         megabytes(total - budget));
+    } else if (projected > budget) {
+      ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f),
+                         "Generating at %dx%d would need about %.1f MB",
+                         cfg.width, cfg.height, megabytes(projected));
+    }
+
+    const auto tableFlags =
+        ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV;
+    if (ImGui::BeginTable("MemoryTable", 2, tableFlags)) {
+      ImGui::TableSetupColumn("Data");
+      ImGui::TableSetupColumn("MB", ImGuiTableColumnFlags_WidthFixed, 100.0f);
+      ImGui::TableHeadersRow();
+      for (const auto &group : memoryLedger.entries()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        const bool open = ImGui::TreeNodeEx(group.name.c_str(),
+                                            ImGuiTreeNodeFlags_SpanFullWidth);
+        ImGui::TableNextColumn();
+        if (group.measured) {
+          ImGui::Text("%.1f", megabytes(group.bytes));
+        } else {
+          ImGui::TextDisabled("...");
+        }
+        if (!open) {
+          continue;
+        }
+        for (const auto &item : group.items) {
+          ImGui::TableNextRow();
+          ImGui::TableNextColumn();
+          ImGui::TextDisabled("%s", item.name.c_str());
+          ImGui::TableNextColumn();
+          ImGui::TextDisabled("%.1f", megabytes(item.bytes));
+        }
+        ImGui::TreePop();
+      }
+      ImGui::EndTable();
+    }
+    ImGui::TextDisabled("Containers and the pixels of areas are followed, "
+                        "other classes count with their own size only.");
+    ImGui::EndTabItem();
+  }
+  return 0;
+}
+
 } // namespace Fwg
\ No newline at end of file
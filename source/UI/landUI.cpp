@@ -37,13 +37,19 @@ void LandUI::RenderScrollableLandInput(
     ImGui::SameLine();
 
     if (ImGui::Button("Apply type to all selected")) {
+      std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> applied;
+      UI::EditHistory::Edit edit(imageData);
       for (const auto &selId : selectedInputs) {
         if (landInputColours.getMap().contains(selId)) {
           auto &entry = landInputColours.getMap().at(selId);
           for (auto &pix : entry.pixels)
-            imageData[pix] = entry.out;
+            edit.set(pix, entry.out);
+          applied.emplace_back(entry.in, entry.out);
         }
       }
+      inputHistory.push(std::move(edit), "apply selected");
+      uiContext.asyncContext.journal.recordClassification(
+          UI::Drops::Target::LAND_INPUT, applied);
       uiContext.imageContext.resetTexture();
       selectedInputs.clear();
     }
@@ -169,8 +175,12 @@ void LandUI::RenderScrollableLandInput(
 
     // --- Apply button (per item) ---
     if (ImGui::Button(("Apply type for " + entry.in.toString()).c_str())) {
+      UI::EditHistory::Edit edit(imageData);
       for (auto &pix : entry.pixels)
-        imageData[pix] = entry.out;
+        edit.set(pix, entry.out);
+      inputHistory.push(std::move(edit), "apply " + entry.in.toString());
+      uiContext.asyncContext.journal.recordClassification(
+          UI::Drops::Target::LAND_INPUT, {{entry.in, entry.out}});
       uiContext.imageContext.resetTexture();
       highlightedInputs.erase(entry.in);
     }
@@ -278,6 +288,47 @@ bool LandUI::analyseLandMap(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
   return !classificationNeeded;
 }
 
+std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+LandUI::applyHighlighted() {
+  std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> applied;
+  UI::EditHistory::Edit edit(landInput.imageData);
+  for (auto &input : landInputColours.getMap()) {
+    if (highlightedInputs.contains(input.second.in)) {
+      for (auto &pix : input.second.pixels) {
+        edit.set(pix, input.second.out);
+      }
+      applied.emplace_back(input.second.in, input.second.out);
+      highlightedInputs.erase(input.second.in);
+    }
+  }
+  inputHistory.push(std::move(edit), "apply all");
+  return applied;
+}
+
+void LandUI::restoreInput(
+    Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg, const Fwg::Gfx::Image &image,
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>> &mapping,
+    int &amountClassificationsNeeded) {
+  landInput = image;
+  inputHistory.clear();
+  highlightedInputs.clear();
+  analyseLandMap(cfg, fwg, landInput, amountClassificationsNeeded);
+  setClassifications(mapping);
+}
+
+void LandUI::setClassifications(
+    const std::vector<std::pair<Fwg::Gfx::Colour, Fwg::Gfx::Colour>>
+        &mapping) {
+  for (const auto &[in, out] : mapping) {
+    if (landInputColours.contains(in)) {
+      landInputColours[in].out = out;
+      if (in != out) {
+        highlightedInputs.insert(in);
+      }
+    }
+  }
+}
+
 void LandUI::complexLandMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                                 bool &analyse, int &amountClassificationsNeeded,
                                 UI::UIContext &uiContext) {
@@ -298,17 +349,18 @@ void LandUI::complexLandMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
   }
   RenderScrollableLandInput(landInput.imageData,
                             cfg.terrainConfig.landformDefinitions, uiContext);
+  if (inputHistory.showControls(
+          landInput.imageData, highlightedInputs,
+          [this](const Fwg::Gfx::Colour &colour) {
+            return landInputColours.contains(colour);
+          })) {
+    uiContext.imageContext.resetTexture();
+  }
   if (highlightedInputs.size() > 0) {
     ImGui::Text("Before next analysis, apply all types");
     if (ImGui::Button("Apply all")) {
-      for (auto &input : landInputColours.getMap()) {
-        if (highlightedInputs.contains(input.second.in)) {
-          for (auto &pix : input.second.pixels) {
-            landInput.setColourAtIndex(pix, input.second.out);
-          }
-          highlightedInputs.erase(input.second.in);
-        }
-      }
+      uiContext.asyncContext.journal.recordClassification(
+          UI::Drops::Target::LAND_INPUT, applyHighlighted());
       uiContext.imageContext.resetTexture();
     }
   } else if (ImGui::Button("Analyse Input") || analyse) {
@@ -320,6 +372,8 @@ void LandUI::complexLandMapping(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
       fwg.genHeightFromInput(cfg, cfg.mapsPath + "/classifiedLandInput.png",
                              cfg.landInputMode);
     }
+    uiContext.asyncContext.journal.recordAnalysis(
+        UI::Drops::Target::LAND_INPUT, !amountClassificationsNeeded);
     uiContext.imageContext.resetTexture();
 
     analyse = false;
@@ -330,17 +384,15 @@ void LandUI::triggeredLandInput(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
                                 const std::string &draggedFile,
                                 const Fwg::Terrain::InputMode &inputMode) {
   originalLandInput = draggedFile;
-  fwg.resetData();
-  fwg.configure(cfg);
   // don't immediately generate from the input, instead allow to manually
   // classify all present colours
-  landInput = Fwg::IO::Reader::readGenericImage(draggedFile, cfg, false);
+  UI::Drops::load({UI::Drops::Target::LAND_INPUT, draggedFile}, cfg, fwg,
+                  landInput);
+  inputHistory.clear();
   std::string outputPath = "";
   switch (inputMode) {
   case Fwg::Terrain::InputMode::HEIGHTMAP:
     outputPath = cfg.mapsPath + "/heightmapInput.png";
-    cfg.allowHeightmapModification = false;
-    fwg.loadHeight(cfg, IO::Reader::readHeightmapImage(draggedFile, cfg));
     break;
   case Fwg::Terrain::InputMode::HEIGHTSKETCH:
     outputPath = cfg.mapsPath + "/heightSketchInput.png";
@@ -351,11 +403,9 @@ void LandUI::triggeredLandInput(Fwg::Cfg &cfg, Fwg::FastWorldGenerator &fwg,
 
   case Fwg::Terrain::InputMode::LANDMASK:
     outputPath = cfg.mapsPath + "/landmaskInput.png";
-    fwg.genHeightFromInput(cfg, draggedFile, inputMode);
     break;
   case Fwg::Terrain::InputMode::LANDFORM:
     outputPath = cfg.mapsPath + "/landformInput.png";
-    fwg.genHeightFromInput(cfg, draggedFile, inputMode);
     break;
   default:
     break;